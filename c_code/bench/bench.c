@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "attribute.h"
+#include "battle.h"
+#include "combat.h"
+#include "simulation.h"
+
+// 每个用例单次至少运行的时间
+#define BENCH_MIN_SECONDS 0.25
+#define BENCH_MAX_CASES 16
+// 每个用例重复运行的次数，取 ns/op 的中位数，单次运行的抖动不会误报退化
+#define BENCH_REPEATS 5
+#define BENCH_MAX_REPEATS 31
+
+// 链接时使用 --wrap 把分配函数转发到这里计数
+static long long allocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+void *__wrap_malloc(size_t size) {
+  allocations++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  allocations++;
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+  allocations++;
+  return __real_realloc(pointer, size);
+}
+
+typedef struct {
+  const char *name;
+  int duels; // 每次操作包含的对局数，0 表示不是对局
+  void (*run)(Context *ctx, long long ops);
+} BenchCase;
+
+typedef struct {
+  long long ops;
+  double nanoseconds; // 每次操作，各次重复的中位数
+  double spread;      // 各次重复的极差占中位数的比例
+  double allocations; // 每次操作
+  double baseline;    // 基线中的 ns/op，0 表示没有
+} BenchResult;
+
+static volatile int benchSink; // 防止结果被优化掉
+static Energy presets[ENERGY_COUNT];
+
+static void benchPresets(Context *ctx, long long ops) {
+  for (long long n = 0; n < ops; ++n) {
+    Energy energy = {.type = n % ENERGY_COUNT};
+    getPresetsAttributes(ctx, &energy);
+    benchSink += energy.health;
+  }
+}
+
+static void benchUpgrade(Context *ctx, long long ops) {
+  for (long long n = 0; n < ops; ++n) {
+    Energy energy = presets[n % ENERGY_COUNT];
+    upgradeRandom(ctx, &energy, 10);
+    benchSink += energy.health;
+  }
+}
+
+static void benchCombat(Context *ctx, long long ops) {
+  for (long long n = 0; n < ops; ++n) {
+    Energy player = presets[n % ENERGY_COUNT];
+    Energy enemy = presets[n / ENERGY_COUNT % ENERGY_COUNT];
+    benchSink += handleCombat(ctx, &player, &enemy);
+  }
+}
+
+static void benchBattleOut(Context *ctx, long long ops) {
+  for (long long n = 0; n < ops; ++n) {
+    Energy player = presets[n % ENERGY_COUNT];
+    Energy enemy = presets[n / ENERGY_COUNT % ENERGY_COUNT];
+    benchSink += handleBattleOut(ctx, &player, &enemy);
+  }
+}
+
+// 与 printAllResults 相同的 5x5 结果表，不输出
+static void benchTable(Context *ctx, long long ops) {
+  for (long long n = 0; n < ops; ++n) {
+    for (int i = 0; i < ENERGY_COUNT; ++i) {
+      for (int j = 0; j < ENERGY_COUNT; ++j) {
+        Energy player = {.type = i};
+        Energy enemy = {.type = j};
+        getPresetsAttributes(ctx, &player);
+        getPresetsAttributes(ctx, &enemy);
+        benchSink += handleBattleOut(ctx, &player, &enemy);
+      }
+    }
+  }
+}
+
+static void benchSimulate(Context *ctx, long long ops) {
+  SimulationConfig config = {.playerLevel = 40, .enemyLevel = 40, .seed = 1};
+  for (long long n = 0; n < ops; ++n) {
+    int health;
+    int rounds;
+    benchSink += simulateBattle(ctx, &config, n % ENERGY_COUNT,
+                                n / ENERGY_COUNT % ENERGY_COUNT, n, &health,
+                                &rounds);
+  }
+}
+
+static const BenchCase benchCases[] = {
+    {"getPresetsAttributes", 0, benchPresets},
+    {"upgradeRandom10", 0, benchUpgrade},
+    {"handleCombat", 0, benchCombat},
+    {"handleBattleOut", 1, benchBattleOut},
+    {"table5x5", ENERGY_COUNT * ENERGY_COUNT, benchTable},
+    {"simulateBattle40", 1, benchSimulate},
+};
+
+#define BENCH_CASE_COUNT (int)(sizeof(benchCases) / sizeof(benchCases[0]))
+
+static double elapsedSeconds(const struct timespec *start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static double runOnce(const BenchCase *bench, long long ops) {
+  Context ctx;
+  initContext(&ctx, 1, LOG_NONE);
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bench->run(&ctx, ops);
+  return elapsedSeconds(&start);
+}
+
+static int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// 操作数逐次翻倍，直到单次运行超过 BENCH_MIN_SECONDS，
+// 再以该操作数重复 repeats 次，取每次操作耗时的中位数
+static BenchResult runCase(const BenchCase *bench, int repeats) {
+  BenchResult result = {0};
+  long long before = 0;
+  for (long long ops = 1;; ops *= 2) {
+    before = allocations;
+    if (runOnce(bench, ops) >= BENCH_MIN_SECONDS) {
+      result.ops = ops;
+      break;
+    }
+  }
+  result.allocations = (allocations - before) / (double)result.ops;
+
+  double samples[BENCH_MAX_REPEATS];
+  for (int r = 0; r < repeats; ++r) {
+    samples[r] = runOnce(bench, result.ops) * 1e9 / result.ops;
+  }
+  qsort(samples, repeats, sizeof(double), compareDouble);
+  result.nanoseconds = samples[repeats / 2]; // 偶数次时取偏大的一个
+  result.spread = (samples[repeats - 1] - samples[0]) / result.nanoseconds;
+  return result;
+}
+
+// 基线文件每行为 "用例名 ns/op"，返回文件是否存在
+static int readBaseline(const char *path, BenchResult *results) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return 0;
+  }
+  char name[64];
+  double nanoseconds;
+  while (fscanf(file, "%63s %lf", name, &nanoseconds) == 2) {
+    for (int i = 0; i < BENCH_CASE_COUNT; ++i) {
+      if (strcmp(name, benchCases[i].name) == 0) {
+        results[i].baseline = nanoseconds;
+      }
+    }
+  }
+  fclose(file);
+  return 1;
+}
+
+static int writeBaseline(const char *path, const BenchResult *results) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    return 0;
+  }
+  for (int i = 0; i < BENCH_CASE_COUNT; ++i) {
+    fprintf(file, "%s %.2f\n", benchCases[i].name, results[i].nanoseconds);
+  }
+  fclose(file);
+  return 1;
+}
+
+// bench [基线文件] [允许退化的百分比] [重复次数] [update]
+// 基线与机器相关，不纳入版本库：在空闲的机器上以 update 运行一次，
+// 写入的也是各用例重复运行的中位数
+int main(int argc, char **argv) {
+  const char *baselinePath = argc > 1 ? argv[1] : NULL;
+  double threshold = argc > 2 ? atof(argv[2]) : 10;
+  int repeats = argc > 3 ? atoi(argv[3]) : BENCH_REPEATS;
+  int update = argc > 4 && strcmp(argv[4], "update") == 0;
+  if (repeats < 1 || repeats > BENCH_MAX_REPEATS) {
+    repeats = BENCH_REPEATS;
+  }
+
+  BenchResult results[BENCH_MAX_CASES] = {0};
+  Context ctx;
+  initContext(&ctx, 1, LOG_NONE);
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    presets[i] = (Energy){.name = "bench", .type = i};
+    getPresetsAttributes(&ctx, &presets[i]);
+  }
+  int hasBaseline = baselinePath && !update &&
+                    readBaseline(baselinePath, results);
+
+  int regressions = 0;
+  printf("%-22s%12s%9s%14s%14s%10s%10s\n", "case", "ns/op", "spread",
+         "ops/s", "duels/s", "allocs", "change");
+  for (int i = 0; i < BENCH_CASE_COUNT; ++i) {
+    const BenchCase *bench = &benchCases[i];
+    double baseline = results[i].baseline;
+    results[i] = runCase(bench, repeats);
+    results[i].baseline = baseline;
+
+    double rate = 1e9 / results[i].nanoseconds;
+    printf("%-22s%12.1f%8.1f%%%14.0f", bench->name, results[i].nanoseconds,
+           results[i].spread * 100, rate);
+    if (bench->duels) {
+      printf("%14.0f", rate * bench->duels);
+    } else {
+      printf("%14s", "-");
+    }
+    printf("%10.2f", results[i].allocations);
+    if (baseline > 0) {
+      double change = (results[i].nanoseconds / baseline - 1) * 100;
+      printf("%+9.1f%%", change);
+      if (change > threshold) {
+        printf("  REGRESSION");
+        regressions++;
+      }
+    }
+    printf("\n");
+  }
+
+  if (baselinePath && !hasBaseline) {
+    if (writeBaseline(baselinePath, results)) {
+      printf("baseline written to %s\n", baselinePath);
+    }
+  } else if (regressions) {
+    printf("%d case(s) regressed more than %.0f%% (median of %d runs)\n",
+           regressions, threshold, repeats);
+    return 1;
+  }
+
+  return 0;
+}
\ No newline at end of file
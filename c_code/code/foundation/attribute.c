@@ -14,74 +14,70 @@ void restoreAttributes(Energy *energy) {
 
 void restoreEffects(Energy *energy) {
   for (int i = 0; i < EFFECT_ID_COUNT; ++i) {
-    energy->effects[i].id = i;
     energy->effects[i].type = limited;
     energy->effects[i].value = 0;
     energy->effects[i].times = 0;
   }
+  energy->activeEffects = 0;
 }
 
-void getPresetsAttributes(Energy *energy) {
+// 各属性的预设数值，被动与技能表中的被动0一致
+// 加点数值与 Flutter 端 healthStep 等一致
+const PresetTable defaultPresets = {
+    .elements =
+        {
+            [METAL] = {128, 32, 32, strengthen, 0.5},
+            [WATER] = {160, 16, 64, adjustAttribute, 0.75},
+            [WOOD] = {256, 32, 16, absorbBlood, 0.25},
+            [FIRE] = {96, 64, 16, enchanting, 1.0},
+            [EARTH] = {384, 16, 0, accumulateAnger, 0.5},
+        },
+    .steps = {[HP] = 32, [ATK] = 8, [DEF] = 8},
+};
+
+static const PresetTable *getPresetTable(const Context *ctx) {
+  return ctx->presets ? ctx->presets : &defaultPresets;
+}
+
+// 上下文挂载了预设表时按其取值，未知属性按金处理
+void getPresetsAttributes(Context *ctx, Energy *energy) {
+  EnergyType type = energy->type < ENERGY_COUNT ? energy->type : METAL;
+  const ElementPreset *preset = &getPresetTable(ctx)->elements[type];
+
   restoreEffects(energy);
-  switch (energy->type) {
-  case METAL:
-    energy->capacityBase = 128;
-    energy->attackBase = 32;
-    energy->defenceBase = 32;
-    energy->effects[strengthen].value = 0.5;
-    energy->effects[strengthen].type = true;
-    break;
-  case WATER:
-    energy->capacityBase = 160;
-    energy->attackBase = 16;
-    energy->defenceBase = 64;
-    energy->effects[adjustAttribute].value = 0.75;
-    energy->effects[adjustAttribute].type = true;
-    break;
-  case WOOD:
-    energy->capacityBase = 256;
-    energy->attackBase = 32;
-    energy->defenceBase = 16;
-    energy->effects[absorbBlood].value = 0.25;
-    energy->effects[absorbBlood].type = true;
-    break;
-  case FIRE:
-    energy->capacityBase = 96;
-    energy->attackBase = 64;
-    energy->defenceBase = 16;
-    energy->effects[enchanting].value = 1.0;
-    energy->effects[enchanting].type = true;
-    break;
-  case EARTH:
-    energy->capacityBase = 384;
-    energy->attackBase = 16;
-    energy->defenceBase = 0;
-    energy->effects[accumulateAnger].value = 0.5;
-    energy->effects[accumulateAnger].type = true;
-    break;
-  default:
-    energy->capacityBase = 128;
-    energy->attackBase = 32;
-    energy->defenceBase = 32;
-    energy->effects[strengthen].value = 0.5;
-    energy->effects[strengthen].type = true;
-    break;
-  }
+  energy->capacityBase = preset->capacityBase;
+  energy->attackBase = preset->attackBase;
+  energy->defenceBase = preset->defenceBase;
+  // 被动由预设表指定，效果与施放被动0相同
+  energy->effects[preset->passive].type = infinite;
+  energy->effects[preset->passive].value = preset->passiveValue;
 
+  refreshEffectMask(energy);
   restoreAttributes(energy);
 }
 
-void upgradeAttributes(Energy *energy, enum AttributeType attribute) {
+// 以 64 位相加后截断到 ATTRIBUTE_LIMIT，步长与等级再大也不会溢出
+static int addAttribute(int base, long long amount) {
+  long long value = base + amount;
+  if (value > ATTRIBUTE_LIMIT) {
+    return ATTRIBUTE_LIMIT;
+  }
+  return value < -ATTRIBUTE_LIMIT ? -ATTRIBUTE_LIMIT : (int)value;
+}
+
+void upgradeAttributes(Context *ctx, Energy *energy,
+                       enum AttributeType attribute) {
+  const int *steps = getPresetTable(ctx)->steps;
   energy->level++;
   switch (attribute) {
   case HP:
-    energy->capacityBase += 32;
+    energy->capacityBase = addAttribute(energy->capacityBase, steps[HP]);
     break;
   case ATK:
-    energy->attackBase += 8;
+    energy->attackBase = addAttribute(energy->attackBase, steps[ATK]);
     break;
   case DEF:
-    energy->defenceBase += 8;
+    energy->defenceBase = addAttribute(energy->defenceBase, steps[DEF]);
     break;
   case ATTRIBUTE_COUNT:
   default:
@@ -90,37 +86,55 @@ void upgradeAttributes(Energy *energy, enum AttributeType attribute) {
   restoreAttributes(energy);
 }
 
-void upgradeRandom(Energy *energy, int times) {
-  for (int i = 0; i < times; i++) {
-    upgradeAttributes(energy, rand() % ATTRIBUTE_COUNT);
+// 一次加上各属性的点数，与逐点调用 upgradeAttributes 的结果相同
+void upgradeBulk(Context *ctx, Energy *energy,
+                 const int points[ATTRIBUTE_COUNT]) {
+  const int *steps = getPresetTable(ctx)->steps;
+  energy->level += points[HP] + points[ATK] + points[DEF];
+  energy->capacityBase = addAttribute(energy->capacityBase,
+                                      (long long)steps[HP] * points[HP]);
+  energy->attackBase =
+      addAttribute(energy->attackBase, (long long)steps[ATK] * points[ATK]);
+  energy->defenceBase =
+      addAttribute(energy->defenceBase, (long long)steps[DEF] * points[DEF]);
+  restoreAttributes(energy);
+}
+
+// 每点等概率分配，各属性的点数服从多项分布，直接抽样而不逐点循环
+void upgradeRandom(Context *ctx, Energy *energy, int times) {
+  if (times <= 0) {
+    return;
   }
+  int points[ATTRIBUTE_COUNT];
+  randomMultinomial(&ctx->random, times, points, ATTRIBUTE_COUNT);
+  upgradeBulk(ctx, energy, points);
 }
 
-void upgradeChoose(Energy *energy) {
+void upgradeChoose(Context *ctx, Energy *energy) {
   int choice;
-  customPrintf("Choose attribute to upgrade:\n");
-  customPrintf("%d. Health\n", HP);
-  customPrintf("%d. Attack\n", ATK);
-  customPrintf("%d. Defense\n", DEF);
-  customPrintf("Enter your choice (%d-%d): ", HP, DEF);
+  customPrintf(ctx, "Choose attribute to upgrade:\n");
+  customPrintf(ctx, "%d. Health\n", HP);
+  customPrintf(ctx, "%d. Attack\n", ATK);
+  customPrintf(ctx, "%d. Defense\n", DEF);
+  customPrintf(ctx, "Enter your choice (%d-%d): ", HP, DEF);
   scanf_s("%d", &choice);
 
   switch (choice) {
   case HP:
-    upgradeAttributes(energy, HP);
-    customPrintf("Health upgraded!\n");
+    upgradeAttributes(ctx, energy, HP);
+    customPrintf(ctx, "Health upgraded!\n");
     break;
   case ATK:
-    upgradeAttributes(energy, ATK);
-    customPrintf("Attack upgraded!\n");
+    upgradeAttributes(ctx, energy, ATK);
+    customPrintf(ctx, "Attack upgraded!\n");
     break;
   case DEF:
-    upgradeAttributes(energy, DEF);
-    customPrintf("Defense upgraded!\n");
+    upgradeAttributes(ctx, energy, DEF);
+    customPrintf(ctx, "Defense upgraded!\n");
     break;
   default:
-    upgradeAttributes(energy, HP);
-    customPrintf("Invalid choice. Default Health.\n");
+    upgradeAttributes(ctx, energy, HP);
+    customPrintf(ctx, "Invalid choice. Default Health.\n");
     break;
   }
 }
\ No newline at end of file
@@ -5,13 +5,38 @@
 extern "C" {
 #endif
 
+#include "context.h"
+#include "effect.h"
 #include "energy.h"
 
+// 加点后生命、攻击、防御的上限，效果加成与伤害计算放大百倍也不会溢出 int
+#define ATTRIBUTE_LIMIT (1 << 24)
+
+typedef struct {
+  int capacityBase;
+  int attackBase;
+  int defenceBase;
+  EffectID passive; // 被动0施加的效果
+  float passiveValue;
+} ElementPreset;
+
+// 平衡调整的对象，可以整体替换后挂到上下文上，也可以从预设文件映射
+typedef struct PresetTable {
+  ElementPreset elements[ENERGY_COUNT];
+  int steps[ATTRIBUTE_COUNT]; // 每个属性点提升的数值
+} PresetTable;
+
+extern const PresetTable defaultPresets;
+
 extern void restoreAttributes(Energy *energy);
-extern void upgradeAttributes(Energy *energy, enum AttributeType attribute);
-extern void upgradeRandom(Energy *energy, int times);
-extern void getPresetsAttributes(Energy *energy);
-extern void upgradeChoose(Energy *energy);
+extern void restoreEffects(Energy *energy);
+extern void upgradeAttributes(Context *ctx, Energy *energy,
+                              enum AttributeType attribute);
+extern void upgradeBulk(Context *ctx, Energy *energy,
+                        const int points[ATTRIBUTE_COUNT]);
+extern void upgradeRandom(Context *ctx, Energy *energy, int times);
+extern void getPresetsAttributes(Context *ctx, Energy *energy);
+extern void upgradeChoose(Context *ctx, Energy *energy);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,23 @@
+#include <stdio.h>
+
+#include "context.h"
+
+void initContext(Context *ctx, uint64_t seed, LogLevel level) {
+  seedRandom(&ctx->random, seed);
+  ctx->sink = fileSink;
+  ctx->sinkData = NULL;
+  ctx->level = level;
+  ctx->trace = NULL;
+  ctx->profiler = NULL;
+  ctx->search = NULL;
+  ctx->enemies = NULL;
+  ctx->presets = NULL;
+  ctx->curve.scheme = CURVE_DEFAULT;
+  ctx->curve.mode = CURVE_DEFAULT_MODE;
+  initReactionDepth(&ctx->reactions, REACTION_CHAIN_LIMIT);
+}
+
+// 输出到 data 指定的文件，为空时输出到标准输出
+int fileSink(void *data, const char *fmt, va_list args) {
+  return vfprintf(data ? (FILE *)data : stdout, fmt, args);
+}
\ No newline at end of file
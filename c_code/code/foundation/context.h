@@ -0,0 +1,47 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+
+#include "curve.h"
+#include "random.h"
+#include "reaction.h"
+
+// 日志等级，数值越大输出越详细
+typedef enum { LOG_NONE, LOG_BATTLE, LOG_DETAIL } LogLevel;
+
+struct TraceBuffer;
+struct Profiler;
+struct DuelSearch;
+struct EnemyCache;
+struct PresetTable;
+
+typedef int (*LogSink)(void *data, const char *fmt, va_list args);
+
+// 引擎上下文，每场对局或每个线程独占一份，引擎内不再有共享的可变状态
+typedef struct {
+  Random random;  // 随机数生成器
+  LogSink sink;   // 日志输出，为空时丢弃
+  void *sinkData; // 传给 sink 的参数
+  LogLevel level; // 日志等级
+  struct TraceBuffer *trace; // 二进制事件轨迹，为空时不记录
+  CurveConfig curve;         // 调整属性曲线的方案与求值方式
+  ReactionDepth reactions;   // 反击链的递归层数与上限
+  struct Profiler *profiler; // 性能计数器，为空时不计量
+  struct DuelSearch *search; // 敌人 AI，为空时敌人随机出手
+  struct EnemyCache *enemies; // 敌人模板缓存，为空时每次重新构建
+  const struct PresetTable *presets; // 属性预设，为空时使用默认预设
+} Context;
+
+extern void initContext(Context *ctx, uint64_t seed, LogLevel level);
+extern int fileSink(void *data, const char *fmt, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTEXT_H
\ No newline at end of file
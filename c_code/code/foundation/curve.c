@@ -0,0 +1,94 @@
+#include <math.h>
+#include <pthread.h>
+
+#include "curve.h"
+
+// 方案0-3 原先以注释形式保存在 handleAdjustByDamage 中，
+// 注释里是各方案配套的预设数值
+static const double curveParameters[CURVE_COUNT][2] = {
+    {0.3, 6.2},
+    // 方案0: absorbBlood 0.4
+    {1.4142135623730951 - 1, 4},
+    // 方案1: absorbBlood 0.32
+    {1.4142135623730951 - 1, 1.75},
+    // 方案2: adjustAttribute 1, defenceBase 24, absorbBlood 0.8,
+    // accumulateAnger 0.75, 伤害公式中防御乘 2
+    {0.28, 3},
+    // 方案3: adjustAttribute 0.75, absorbBlood 0.125
+    {1.4142135623730951 - 1, 3.05},
+};
+
+const char *curveNames[CURVE_COUNT] = {"default", "scheme0", "scheme1",
+                                       "scheme2", "scheme3"};
+
+static CurveTable curveTables[CURVE_COUNT];
+static pthread_once_t curveOnce = PTHREAD_ONCE_INIT;
+
+// |f''(x)|，f(x) = (x + offset)^exponent
+static double curveSecond(const CurveTable *table, double x) {
+  double e = table->exponent;
+  return fabs(e * (e - 1) * pow(x + table->offset, e - 2));
+}
+
+static void buildCurveTables(void) {
+  double step = CURVE_RANGE / CURVE_STEPS;
+  for (int s = 0; s < CURVE_COUNT; ++s) {
+    CurveTable *table = &curveTables[s];
+    table->offset = curveParameters[s][0];
+    table->exponent = curveParameters[s][1];
+    for (int i = 0; i <= CURVE_STEPS; ++i) {
+      table->values[i] = pow(i * step + table->offset, table->exponent);
+    }
+    for (int i = 0; i < CURVE_STEPS; ++i) {
+      double second = fmax(curveSecond(table, i * step),
+                           curveSecond(table, (i + 1) * step));
+      // 插值误差加上表值和插值运算的舍入余量
+      double error = step * step / 8 * second + table->values[i + 1] * 1e-12;
+      table->errors[i] = error * (1 + 1e-6);
+    }
+  }
+}
+
+const CurveTable *getCurveTable(CurveScheme scheme) {
+  pthread_once(&curveOnce, buildCurveTables);
+  return &curveTables[scheme];
+}
+
+static double interpolate(const CurveTable *table, double healthRatio,
+                          int *segment) {
+  double position = healthRatio * (CURVE_STEPS / CURVE_RANGE);
+  int i = (int)position;
+  *segment = i;
+  return table->values[i] +
+         (table->values[i + 1] - table->values[i]) * (position - i);
+}
+
+static int inTable(double healthRatio) {
+  return healthRatio >= 0 && healthRatio < CURVE_RANGE;
+}
+
+double curveValue(const CurveConfig *config, double healthRatio) {
+  const CurveTable *table = getCurveTable(config->scheme);
+  if (config->mode == CURVE_TABLE && inTable(healthRatio)) {
+    int segment;
+    return interpolate(table, healthRatio, &segment);
+  }
+  return pow(healthRatio + table->offset, table->exponent);
+}
+
+// 返回 round(scale * f(healthRatio))，scale 为基础防御乘以伤害或恢复比例
+int curveAdjustValue(const CurveConfig *config, double scale,
+                     double healthRatio) {
+  const CurveTable *table = getCurveTable(config->scheme);
+  if (config->mode == CURVE_TABLE && inTable(healthRatio)) {
+    int segment;
+    double value = scale * interpolate(table, healthRatio, &segment);
+    double margin = fabs(scale) * table->errors[segment];
+    int rounded = roundToInt(value);
+    // 离最近的 k + 0.5 足够远时，精确值与近似值取整结果相同
+    if (0.5 - fabs(value - rounded) > margin) {
+      return rounded;
+    }
+  }
+  return roundToInt(scale * pow(healthRatio + table->offset, table->exponent));
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef CURVE_H
+#define CURVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 调整属性曲线 (生命比例 + offset)^exponent 的查表近似
+//
+// 表覆盖生命比例 [0, CURVE_RANGE)，CURVE_STEPS 段线性插值，每段保存误差上界
+// h^2 / 8 * max|f''| (f'' 在段内单调，取两端较大者) 再加上浮点舍入余量。
+// 默认曲线 0.3/6.2 在 [0, 1] 内上界约 5e-5，在 2 附近约 5e-4。
+// 查表结果与 round 的边界 (k + 0.5) 距离小于 scale * 上界时回退到 pow，
+// 所以 CURVE_TABLE 的取整结果与 CURVE_EXACT 完全一致；范围外同样回退。
+
+#define CURVE_RANGE 2.0
+#define CURVE_STEPS 1024
+
+typedef enum {
+  CURVE_DEFAULT, // 0.3, 6.2
+  CURVE_SCHEME0, // sqrt(2) - 1, 4
+  CURVE_SCHEME1, // sqrt(2) - 1, 1.75
+  CURVE_SCHEME2, // 0.28, 3
+  CURVE_SCHEME3, // sqrt(2) - 1, 3.05
+  CURVE_COUNT
+} CurveScheme;
+
+typedef enum { CURVE_EXACT, CURVE_TABLE } CurveMode;
+
+// 编译时加 EXACT_CURVE 则默认每次都调用 pow
+#ifdef EXACT_CURVE
+#define CURVE_DEFAULT_MODE CURVE_EXACT
+#else
+#define CURVE_DEFAULT_MODE CURVE_TABLE
+#endif
+
+typedef struct {
+  CurveScheme scheme;
+  CurveMode mode;
+} CurveConfig;
+
+typedef struct {
+  double offset;
+  double exponent;
+  double values[CURVE_STEPS + 1];
+  float errors[CURVE_STEPS]; // 每段插值的绝对误差上界
+} CurveTable;
+
+extern const char *curveNames[CURVE_COUNT];
+
+// 与 round() 相同的远离零取整，要求 |x| 在 int 范围内
+static inline int roundToInt(double x) {
+  long long whole = (long long)x;
+  double fraction = x - whole;
+  return whole + (fraction >= 0.5) - (fraction <= -0.5);
+}
+
+extern const CurveTable *getCurveTable(CurveScheme scheme);
+extern double curveValue(const CurveConfig *config, double healthRatio);
+extern int curveAdjustValue(const CurveConfig *config, double scale,
+                            double healthRatio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CURVE_H
\ No newline at end of file
@@ -1,20 +1,35 @@
 #include <stdarg.h>
 #include <stdio.h>
 
-#include "custom.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
-bool flag_debug = true;
+#include "custom.h"
 
-int customPrintf(char *fmt, ...) {
+int customPrintf(const Context *ctx, char *fmt, ...) {
 
-  if (flag_debug) {
+  if (ctx->level > LOG_NONE && ctx->sink) {
     va_list args;
     int count;
     va_start(args, fmt);
-    count = vprintf(fmt, args);
+    count = ctx->sink(ctx->sinkData, fmt, args);
     va_end(args);
     return count;
   } else {
     return 0;
   }
+}
+
+int getProcessorCount() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? count : 1;
+#endif
 }
\ No newline at end of file
@@ -5,10 +5,24 @@
 extern "C" {
 #endif
 
-#include <stdbool.h>
+#include "context.h"
 
-extern bool flag_debug;
-extern int customPrintf(char *fmt, ...);
+// 引擎日志：定义 NO_LOG 时整条语句被编译掉，否则先判断等级再求值参数
+#ifdef NO_LOG
+#define LOG_ENABLED(ctx, lv) 0
+#else
+#define LOG_ENABLED(ctx, lv) ((ctx)->level >= (lv))
+#endif
+
+#define LOG_PRINT(ctx, lv, ...)                                                \
+  do {                                                                         \
+    if (LOG_ENABLED(ctx, lv)) {                                                \
+      customPrintf((ctx), __VA_ARGS__);                                        \
+    }                                                                          \
+  } while (0)
+
+extern int customPrintf(const Context *ctx, char *fmt, ...);
+extern int getProcessorCount();
 
 #ifdef __cplusplus
 }
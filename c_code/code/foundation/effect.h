@@ -5,6 +5,8 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+
 typedef enum {
   restoreLife,
   multipleHit,
@@ -32,11 +34,12 @@ typedef enum {
 
 typedef enum { limited, infinite } EffectType;
 
+// 紧凑布局，下标即效果编号，不再单独保存 id
 typedef struct {
-  EffectID id;
-  EffectType type;
-  double value;
-  int times;
+  float value;
+  int16_t times;
+  uint8_t type; // EffectType
+  uint8_t reserved;
 } CombatEffect;
 
 extern int checkEffect(CombatEffect *effect);
@@ -1,47 +1,89 @@
+#include <stddef.h>
+
 #include "energy.h"
 #include "custom.h"
 
+_Static_assert(sizeof(CombatEffect) == 8, "CombatEffect must stay packed");
+_Static_assert(offsetof(Energy, effects) <= 64,
+               "hot stats must fit in one cache line");
+_Static_assert(sizeof(Energy) <= 256, "Energy grew beyond four cache lines");
+
 const char *energyNames[ENERGY_COUNT] = {"🔩", "🌊", "🪵", "🔥", "🪨"};
 
 const char *attributeNames[6] = {"name",   "energy", "level",
                                  "health", "attack", "defense"};
 
-void printAttributes(const Energy *energy) {
-  customPrintf("%s: %s\n", attributeNames[0], energy->name);
-  customPrintf("%s: %s\n", attributeNames[1], energyNames[energy->type]);
-  customPrintf("%s: %d\n", attributeNames[2], energy->level);
-  customPrintf("%s: %d\n", attributeNames[3], energy->health);
-  customPrintf("%s: %d\n", attributeNames[4],
+// 直接修改 effects 后需调用，重新计算整张掩码
+void refreshEffectMask(Energy *energy) {
+  energy->activeEffects = 0;
+  for (int i = 0; i < EFFECT_ID_COUNT; ++i) {
+    if (checkEffect(&energy->effects[i])) {
+      energy->activeEffects |= EFFECT_BIT(i);
+    }
+  }
+}
+
+// 与 expendEffect 一致，次数用尽时清除对应位
+int expendEnergyEffect(Energy *energy, EffectID id) {
+  if (!EFFECT_ACTIVE(energy, id)) {
+    return 0;
+  }
+  CombatEffect *effect = &energy->effects[id];
+  if (effect->type != infinite && --effect->times <= 0) {
+    energy->activeEffects &= ~EFFECT_BIT(id);
+  }
+  return 1;
+}
+
+void setEffectTimes(Energy *energy, EffectID id, int times) {
+  CombatEffect *effect = &energy->effects[id];
+  effect->times = times;
+  if (checkEffect(effect)) {
+    energy->activeEffects |= EFFECT_BIT(id);
+  } else {
+    energy->activeEffects &= ~EFFECT_BIT(id);
+  }
+}
+
+void printAttributes(const Context *ctx, const Energy *energy) {
+  customPrintf(ctx, "%s: %s\n", attributeNames[0], energy->name);
+  customPrintf(ctx, "%s: %s\n", attributeNames[1], energyNames[energy->type]);
+  customPrintf(ctx, "%s: %d\n", attributeNames[2], energy->level);
+  customPrintf(ctx, "%s: %d\n", attributeNames[3], energy->health);
+  customPrintf(ctx, "%s: %d\n", attributeNames[4],
                energy->attackBase + energy->attackOffset);
-  customPrintf("%s: %d\n", attributeNames[5],
+  customPrintf(ctx, "%s: %d\n", attributeNames[5],
                energy->defenceBase + energy->defenceOffset);
 
-  customPrintf("\n");
+  customPrintf(ctx, "\n");
 }
 
-void printAttributesBattle(const Energy *source, const Energy *target) {
+void printAttributesBattle(const Context *ctx, const Energy *source,
+                           const Energy *target) {
 
   int width = 15;
 
-  customPrintf("\n");
+  customPrintf(ctx, "\n");
 
-  customPrintf("%-*s: %-*s %-*s %-*s: %-*s\n", width, attributeNames[0], 10,
-               source->name, 5, "->", width, attributeNames[0], width,
+  customPrintf(ctx, "%-*s: %-*s %-*s %-*s: %-*s\n", width, attributeNames[0],
+               10, source->name, 5, "->", width, attributeNames[0], width,
                target->name);
-  customPrintf("%-*s: %-*s  %-*s: %-*s\n", width, attributeNames[1], width + 2,
-               energyNames[source->type], width, attributeNames[1], width + 2,
-               energyNames[target->type]);
-  customPrintf("%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[2], width,
-               source->level, width, attributeNames[2], width, target->level);
-  customPrintf("%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[3], width,
-               source->health, width, attributeNames[3], width, target->health);
-  customPrintf("%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[4], width,
-               source->attackBase + source->attackOffset, width,
+  customPrintf(ctx, "%-*s: %-*s  %-*s: %-*s\n", width, attributeNames[1],
+               width + 2, energyNames[source->type], width, attributeNames[1],
+               width + 2, energyNames[target->type]);
+  customPrintf(ctx, "%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[2],
+               width, source->level, width, attributeNames[2], width,
+               target->level);
+  customPrintf(ctx, "%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[3],
+               width, source->health, width, attributeNames[3], width,
+               target->health);
+  customPrintf(ctx, "%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[4],
+               width, source->attackBase + source->attackOffset, width,
                attributeNames[4], width,
                target->attackBase + target->attackOffset);
-  customPrintf("%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[5], width,
-               source->defenceBase + source->defenceOffset, width,
+  customPrintf(ctx, "%-*s: %-*d  %-*s: %-*d\n", width, attributeNames[5],
+               width, source->defenceBase + source->defenceOffset, width,
                attributeNames[5], width,
                target->defenceBase + target->defenceOffset);
-  customPrintf("\n");
+  customPrintf(ctx, "\n");
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 extern "C" {
 #endif
 
+#include "context.h"
 #include "effect.h"
 
 typedef enum { METAL, WATER, WOOD, FIRE, EARTH, ENERGY_COUNT } EnergyType;
@@ -12,8 +13,13 @@ extern const char *energyNames[ENERGY_COUNT];
 
 enum AttributeType { HP, ATK, DEF, ATTRIBUTE_COUNT };
 
+#define EFFECT_BIT(id) (1u << (id))
+// 效果是否生效，等价于 checkEffect，但只读掩码
+#define EFFECT_ACTIVE(energy, id)                                              \
+  (((energy)->activeEffects & EFFECT_BIT(id)) != 0)
+
+// 热数据在前，与前几个效果同处第一条缓存行；名称只在打印时使用，放在末尾
 typedef struct {
-  char name[32];
   EnergyType type;
   int level;
   int health;
@@ -23,11 +29,17 @@ typedef struct {
   int attackOffset;
   int defenceBase;
   int defenceOffset;
+  unsigned int activeEffects; // 生效中的效果位掩码，由效果接口维护
   CombatEffect effects[EFFECT_ID_COUNT];
+  const char *name; // 指向静态字符串，不随结构体复制内容
 } Energy;
 
-extern void printAttributes(const Energy *energy);
-extern void printAttributesBattle(const Energy *source, const Energy *target);
+extern void refreshEffectMask(Energy *energy);
+extern int expendEnergyEffect(Energy *energy, EffectID id);
+extern void setEffectTimes(Energy *energy, EffectID id, int times);
+extern void printAttributes(const Context *ctx, const Energy *energy);
+extern void printAttributesBattle(const Context *ctx, const Energy *source,
+                                  const Energy *target);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,182 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "preset.h"
+
+static uint32_t checksumTable(const PresetTable *table) {
+  const uint8_t *bytes = (const uint8_t *)table;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < sizeof(PresetTable); ++i) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// 先写临时文件再改名，正在读取旧文件的进程不受影响
+int savePresetFile(const PresetTable *table, const char *path) {
+  PresetFileHeader header = {.magic = PRESET_MAGIC,
+                             .version = PRESET_VERSION,
+                             .headerSize = sizeof(PresetFileHeader),
+                             .tableSize = sizeof(PresetTable),
+                             .elementCount = ENERGY_COUNT,
+                             .attributeCount = ATTRIBUTE_COUNT,
+                             .effectCount = EFFECT_ID_COUNT,
+                             .checksum = checksumTable(table)};
+  char temporary[1024];
+  snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+  FILE *file = fopen(temporary, "wb");
+  if (file == NULL) {
+    return 0;
+  }
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(table, sizeof(PresetTable), 1, file) == 1;
+  ok = fclose(file) == 0 && ok;
+#ifdef _WIN32
+  remove(path); // Windows 下 rename 不覆盖已有文件
+#endif
+  return ok && rename(temporary, path) == 0;
+}
+
+// 生命必须为正，攻击、防御与被动数值不能为负，且都不超过各自的上限
+static int checkElementPreset(const ElementPreset *preset) {
+  return preset->capacityBase > 0 &&
+         preset->capacityBase <= PRESET_VALUE_LIMIT &&
+         preset->attackBase >= 0 && preset->attackBase <= PRESET_VALUE_LIMIT &&
+         preset->defenceBase >= 0 &&
+         preset->defenceBase <= PRESET_VALUE_LIMIT &&
+         (unsigned)preset->passive < EFFECT_ID_COUNT &&
+         isfinite(preset->passiveValue) && preset->passiveValue >= 0 &&
+         preset->passiveValue <= PRESET_PASSIVE_LIMIT;
+}
+
+// 检查文件头、校验和与每项数值的范围，不复制数据
+static int checkPresetFile(const void *data, size_t size) {
+  const PresetFileHeader *header = data;
+  if (size < sizeof(PresetFileHeader) || header->magic != PRESET_MAGIC ||
+      header->version != PRESET_VERSION ||
+      header->headerSize < sizeof(PresetFileHeader) ||
+      header->headerSize % sizeof(uint64_t) != 0 ||
+      header->tableSize != sizeof(PresetTable) ||
+      header->elementCount != ENERGY_COUNT ||
+      header->attributeCount != ATTRIBUTE_COUNT ||
+      header->effectCount != EFFECT_ID_COUNT ||
+      size < (size_t)header->headerSize + header->tableSize) {
+    return 0;
+  }
+  const PresetTable *table =
+      (const PresetTable *)((const uint8_t *)data + header->headerSize);
+  if (checksumTable(table) != header->checksum) {
+    return 0;
+  }
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    if (!checkElementPreset(&table->elements[i])) {
+      return 0;
+    }
+  }
+  for (int a = 0; a < ATTRIBUTE_COUNT; ++a) {
+    if (table->steps[a] < 0 || table->steps[a] > PRESET_VALUE_LIMIT) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+#ifdef _WIN32
+int openPresetFile(PresetFile *file, const char *path) {
+  memset(file, 0, sizeof(PresetFile));
+  HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return 0;
+  }
+  LARGE_INTEGER size;
+  HANDLE mapping = NULL;
+  if (GetFileSizeEx(handle, &size) && size.QuadPart > 0) {
+    mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  }
+  CloseHandle(handle); // 映射会保持文件打开
+  if (mapping == NULL) {
+    return 0;
+  }
+  const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == NULL || !checkPresetFile(data, (size_t)size.QuadPart)) {
+    if (data) {
+      UnmapViewOfFile(data);
+    }
+    CloseHandle(mapping);
+    return 0;
+  }
+  file->data = data;
+  file->size = (size_t)size.QuadPart;
+  file->mapping = mapping;
+  file->table = (const PresetTable *)((const uint8_t *)data +
+                                      ((const PresetFileHeader *)data)
+                                          ->headerSize);
+  return 1;
+}
+
+void closePresetFile(PresetFile *file) {
+  if (file->data) {
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mapping);
+  }
+  memset(file, 0, sizeof(PresetFile));
+}
+#else
+int openPresetFile(PresetFile *file, const char *path) {
+  memset(file, 0, sizeof(PresetFile));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat status;
+  void *data = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && status.st_size > 0) {
+    data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd); // 映射会保持文件打开
+  if (data == MAP_FAILED) {
+    return 0;
+  }
+  if (!checkPresetFile(data, status.st_size)) {
+    munmap(data, status.st_size);
+    return 0;
+  }
+  file->data = data;
+  file->size = status.st_size;
+  file->table = (const PresetTable *)((const uint8_t *)data +
+                                      ((const PresetFileHeader *)data)
+                                          ->headerSize);
+  return 1;
+}
+
+void closePresetFile(PresetFile *file) {
+  if (file->data) {
+    munmap((void *)file->data, file->size);
+  }
+  memset(file, 0, sizeof(PresetFile));
+}
+#endif
+
+void printPresetTable(const PresetTable *table) {
+  printf("%-8s%10s%10s%10s%10s%10s\n", "", "health", "attack", "defence",
+         "passive", "value");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    const ElementPreset *preset = &table->elements[i];
+    printf("%-10s%10d%10d%10d%10d%10.4g\n", energyNames[i],
+           preset->capacityBase, preset->attackBase, preset->defenceBase,
+           preset->passive, preset->passiveValue);
+  }
+  printf("%-8s%10d%10d%10d\n", "step", table->steps[HP], table->steps[ATK],
+         table->steps[DEF]);
+}
\ No newline at end of file
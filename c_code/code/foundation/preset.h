@@ -0,0 +1,52 @@
+#ifndef PRESET_H
+#define PRESET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "attribute.h"
+
+#define PRESET_MAGIC 0x53525045 // "EPRS"
+#define PRESET_VERSION 1
+// 预设中生命、攻击、防御与步长的上限，加点按 64 位计算并截断到
+// ATTRIBUTE_LIMIT，所以任意等级下都不会溢出
+#define PRESET_VALUE_LIMIT (1 << 20)
+// 被动数值是倍率，放大属性后同样要留在 ATTRIBUTE_LIMIT 的余量之内
+#define PRESET_PASSIVE_LIMIT 16
+
+// 文件头之后紧跟一份与内存布局完全相同的 PresetTable，映射后直接使用
+// 属性按 EnergyType 顺序 (金、水、木、火、土) 排列，与 Flutter 端的顺序不同
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize; // 预设表相对文件开头的偏移
+  uint32_t tableSize;  // 与 sizeof(PresetTable) 不同时拒绝加载
+  uint32_t elementCount;
+  uint32_t attributeCount;
+  uint32_t effectCount;
+  uint32_t checksum; // 预设表的 FNV-1a
+  uint32_t reserved;
+} PresetFileHeader;
+
+// 映射中的预设文件，table 指向映射内存，关闭前一直有效
+typedef struct {
+  const PresetTable *table;
+  const void *data;
+  size_t size;
+  void *mapping; // Windows 下的映射句柄
+} PresetFile;
+
+extern int savePresetFile(const PresetTable *table, const char *path);
+extern int openPresetFile(PresetFile *file, const char *path);
+extern void closePresetFile(PresetFile *file);
+extern void printPresetTable(const PresetTable *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRESET_H
\ No newline at end of file
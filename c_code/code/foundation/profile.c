@@ -0,0 +1,141 @@
+#include <string.h>
+
+#include "profile.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 校准读取开销时的空采样次数
+#define PROFILE_CALIBRATION 4096
+
+const char *profileCounterNames[PROFILE_COUNTER_COUNT] = {
+    "task-ns", "cycles", "instructions", "branch-miss", "L1d-miss", "LLC-miss"};
+
+const char *profileStageNames[PROFILE_STAGE_COUNT] = {
+    "duel", "handleAttackEffect", "handleDefenceEffect",
+    "handleCoeffcientEffect", "handleDamage"};
+
+#ifdef __linux__
+
+#define CACHE_READ_MISS(cache)                                                 \
+  ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) |                             \
+   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const uint32_t counterTypes[PROFILE_COUNTER_COUNT] = {
+    PERF_TYPE_SOFTWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+    PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+
+static const uint64_t counterConfigs[PROFILE_COUNTER_COUNT] = {
+    PERF_COUNT_SW_TASK_CLOCK,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D),
+    CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)};
+
+static int openCounter(ProfileCounter counter, int group) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = counterTypes[counter];
+  attr.config = counterConfigs[counter];
+  attr.disabled = group < 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+#endif
+
+// 打开当前线程的计数器组，一个都打不开时返回 0
+int initProfiler(Profiler *profiler) {
+  memset(profiler, 0, sizeof(Profiler));
+  profiler->leader = -1;
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    profiler->fds[i] = -1;
+    profiler->slots[i] = -1;
+  }
+
+#ifdef __linux__
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    int fd = openCounter(i, profiler->leader);
+    if (fd < 0) {
+      continue;
+    }
+    if (profiler->leader < 0) {
+      profiler->leader = fd;
+    }
+    profiler->fds[i] = fd;
+    profiler->slots[i] = profiler->opened++;
+  }
+  if (profiler->leader < 0) {
+    return 0;
+  }
+  ioctl(profiler->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(profiler->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+  ProfileStat calibration = {0};
+  for (int n = 0; n < PROFILE_CALIBRATION; ++n) {
+    ProfileSample start;
+    readProfile(profiler, &start);
+    endProfile(profiler, &calibration, &start);
+  }
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    profiler->overhead.values[i] =
+        calibration.totals[i] / PROFILE_CALIBRATION;
+  }
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+void freeProfiler(Profiler *profiler) {
+#ifdef __linux__
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    if (profiler->fds[i] >= 0) {
+      close(profiler->fds[i]);
+    }
+  }
+#endif
+  profiler->leader = -1;
+}
+
+int hasProfileCounter(const Profiler *profiler, ProfileCounter counter) {
+  return profiler->fds[counter] >= 0;
+}
+
+// 一次系统调用读出整组计数器
+void readProfile(const Profiler *profiler, ProfileSample *sample) {
+  memset(sample, 0, sizeof(ProfileSample));
+#ifdef __linux__
+  uint64_t buffer[1 + PROFILE_COUNTER_COUNT];
+  if (profiler->leader < 0 ||
+      read(profiler->leader, buffer, sizeof(buffer)) <= 0) {
+    return;
+  }
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    if (profiler->slots[i] >= 0) {
+      sample->values[i] = buffer[1 + profiler->slots[i]];
+    }
+  }
+#endif
+}
+
+// 累加从 start 到现在的差值，并扣除读取本身的开销
+void endProfile(const Profiler *profiler, ProfileStat *stat,
+                const ProfileSample *start) {
+  ProfileSample end;
+  readProfile(profiler, &end);
+  stat->calls++;
+  for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+    double delta = (double)(end.values[i] - start->values[i]) -
+                   profiler->overhead.values[i];
+    stat->totals[i] += delta > 0 ? delta : 0;
+  }
+}
\ No newline at end of file
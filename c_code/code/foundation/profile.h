@@ -0,0 +1,77 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// 性能计数器，Linux 下通过 perf_event_open 读取，其他平台不可用
+typedef enum {
+  PROFILE_TASK_CLOCK, // 纳秒，软件事件，虚拟机中通常也可用
+  PROFILE_CYCLES,
+  PROFILE_INSTRUCTIONS,
+  PROFILE_BRANCH_MISSES,
+  PROFILE_L1D_MISSES,
+  PROFILE_LLC_MISSES,
+  PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+// 计量的阶段，嵌套调用时外层阶段包含内层
+typedef enum {
+  PROFILE_DUEL,
+  PROFILE_ATTACK_EFFECT,
+  PROFILE_DEFENCE_EFFECT,
+  PROFILE_COEFF_EFFECT,
+  PROFILE_DAMAGE,
+  PROFILE_STAGE_COUNT
+} ProfileStage;
+
+typedef struct {
+  uint64_t values[PROFILE_COUNTER_COUNT];
+} ProfileSample;
+
+typedef struct {
+  uint64_t calls;
+  double totals[PROFILE_COUNTER_COUNT];
+} ProfileStat;
+
+typedef struct Profiler {
+  int leader;                      // 计数器组的首个文件描述符，-1 表示不可用
+  int fds[PROFILE_COUNTER_COUNT];  // 打开失败的计数器为 -1
+  int slots[PROFILE_COUNTER_COUNT]; // 在组读取结果中的位置
+  int opened;
+  ProfileSample overhead; // 一次空的开始/结束读取本身的开销
+  ProfileStat stages[PROFILE_STAGE_COUNT];
+} Profiler;
+
+extern const char *profileCounterNames[PROFILE_COUNTER_COUNT];
+extern const char *profileStageNames[PROFILE_STAGE_COUNT];
+
+// 在调用处计量一个阶段，result 接收 call 的返回值
+#define PROFILE_CALL(ctx, stage, result, call)                                 \
+  do {                                                                         \
+    if ((ctx)->profiler) {                                                     \
+      ProfileSample profileStart;                                              \
+      readProfile((ctx)->profiler, &profileStart);                             \
+      result = call;                                                           \
+      endProfile((ctx)->profiler, &(ctx)->profiler->stages[stage],             \
+                 &profileStart);                                               \
+    } else {                                                                   \
+      result = call;                                                           \
+    }                                                                          \
+  } while (0)
+
+extern int initProfiler(Profiler *profiler);
+extern void freeProfiler(Profiler *profiler);
+extern int hasProfileCounter(const Profiler *profiler, ProfileCounter counter);
+extern void readProfile(const Profiler *profiler, ProfileSample *sample);
+extern void endProfile(const Profiler *profiler, ProfileStat *stat,
+                       const ProfileSample *start);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILE_H
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include <math.h>
+
+#include "random.h"
+
+static uint64_t rotateLeft(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64，用于把种子展开为完整的状态
+static uint64_t splitMix(uint64_t *x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+void seedRandom(Random *random, uint64_t seed) {
+  seedRandomStream(random, seed, 0);
+}
+
+// 由 (种子, 流编号) 直接推导状态，第 N 场对局只取决于 N，与线程调度无关
+void seedRandomStream(Random *random, uint64_t seed, uint64_t stream) {
+  uint64_t x = seed;
+  uint64_t key = splitMix(&x) ^ stream;
+  x = splitMix(&key) ^ seed;
+  for (int i = 0; i < 4; ++i) {
+    random->state[i] = splitMix(&x);
+  }
+  random->mirror = 0;
+}
+
+// 切换为对偶序列，之后的每个输出都与原序列互补
+void mirrorRandom(Random *random) { random->mirror = ~random->mirror; }
+
+uint64_t nextRandom64(Random *random) {
+  uint64_t *s = random->state;
+  uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotateLeft(s[3], 45);
+
+  return result ^ random->mirror;
+}
+
+// 前进 2^128 步，用于从同一状态切出互不重叠的子序列
+void jumpRandom(Random *random) {
+  static const uint64_t jump[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                  0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+  uint64_t s[4] = {0, 0, 0, 0};
+
+  for (int i = 0; i < 4; ++i) {
+    for (int b = 0; b < 64; ++b) {
+      if (jump[i] & (1ULL << b)) {
+        for (int k = 0; k < 4; ++k) {
+          s[k] ^= random->state[k];
+        }
+      }
+      nextRandom64(random);
+    }
+  }
+
+  for (int k = 0; k < 4; ++k) {
+    random->state[k] = s[k];
+  }
+}
+
+uint32_t nextRandom(Random *random) { return nextRandom64(random) >> 32; }
+
+// 返回 [0, bound) 的整数
+int randomBelow(Random *random, int bound) {
+  return (int)(((uint64_t)nextRandom(random) * (uint32_t)bound) >> 32);
+}
+
+// 返回 [0, 1) 的浮点数
+double randomUnit(Random *random) {
+  return (nextRandom64(random) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// 逆变换法，期望循环次数约为 n * p，只用于均值较小的情况
+static int binomialInversion(Random *random, int n, double p) {
+  double q = 1 - p;
+  double s = p / q;
+  double a = (n + 1) * s;
+  for (;;) {
+    double r = pow(q, n);
+    double u = randomUnit(random);
+    int x = 0;
+    while (u > r) {
+      u -= r;
+      x++;
+      r *= a / x - s;
+      if (x > n) {
+        break; // 浮点误差导致越界，重新抽样
+      }
+    }
+    if (x <= n) {
+      return x;
+    }
+  }
+}
+
+// Stirling 公式的修正项 log(k!) - [(k + 0.5) log(k + 1) - (k + 1) + log(2π) / 2]
+static double stirlingCorrection(int k) {
+  static const double table[10] = {
+      0.08106146679532726, 0.04134069595540929, 0.02767792568499834,
+      0.02079067210376509, 0.01664469118982119, 0.01387612882307075,
+      0.01189670994589177, 0.01041126526197209, 0.00925546218271273,
+      0.00833056343336287};
+  if (k < 10) {
+    return table[k];
+  }
+  double t = 1.0 / (k + 1);
+  double t2 = t * t;
+  return (1.0 / 12 - (1.0 / 360 - 1.0 / 1260 * t2) * t2) * t;
+}
+
+// Hörmann 的 BTRD 变换拒绝法，期望抽样次数与 n 无关
+static int binomialRejection(Random *random, int n, double p) {
+  double q = 1 - p;
+  double spq = sqrt(n * p * q);
+  double b = 1.15 + 2.53 * spq;
+  double a = -0.0873 + 0.0248 * b + 0.01 * p;
+  double c = n * p + 0.5;
+  double alpha = (2.83 + 5.1 / b) * spq;
+  double vr = 0.92 - 4.2 / b;
+  double r = p / q;
+  double nr = (n + 1) * r;
+  double npq = n * p * q;
+  int m = (int)((n + 1) * p);
+
+  for (;;) {
+    double u;
+    double v = randomUnit(random);
+    if (v <= 0.86 * vr) {
+      u = v / vr - 0.43;
+      return (int)floor((2 * a / (0.5 - fabs(u)) + b) * u + c);
+    }
+    if (v >= vr) {
+      u = randomUnit(random) - 0.5;
+    } else {
+      u = v / vr - 0.93;
+      u = (u < 0 ? -0.5 : 0.5) - u;
+      v = randomUnit(random) * vr;
+    }
+
+    double us = 0.5 - fabs(u);
+    double kf = floor((2 * a / us + b) * u + c);
+    if (kf < 0 || kf > n) {
+      continue;
+    }
+    int k = (int)kf;
+    v = v * alpha / (a / (us * us) + b);
+    int km = k > m ? k - m : m - k;
+
+    if (km <= 15) {
+      // 靠近众数时直接递推 f(k) / f(m)
+      double f = 1;
+      if (m < k) {
+        for (int i = m + 1; i <= k; ++i) {
+          f *= nr / i - r;
+        }
+      } else {
+        for (int i = k + 1; i <= m; ++i) {
+          v *= nr / i - r;
+        }
+      }
+      if (v <= f) {
+        return k;
+      }
+      continue;
+    }
+
+    v = log(v);
+    double rho =
+        (km / npq) * (((km / 3.0 + 0.625) * km + 1.0 / 6) / npq + 0.5);
+    double t = -(double)km * km / (2 * npq);
+    if (v < t - rho) {
+      return k;
+    }
+    if (v > t + rho) {
+      continue;
+    }
+    int nm = n - m + 1;
+    double h = (m + 0.5) * log((m + 1) / (r * nm)) + stirlingCorrection(m) +
+               stirlingCorrection(n - m);
+    int nk = n - k + 1;
+    if (v <= h + (n + 1) * log((double)nm / nk) +
+                 (k + 0.5) * log(nk * r / (k + 1)) - stirlingCorrection(k) -
+                 stirlingCorrection(n - k)) {
+      return k;
+    }
+  }
+}
+
+// 返回服从二项分布 B(n, p) 的整数，耗时与 n 无关
+int randomBinomial(Random *random, int n, double p) {
+  if (n <= 0 || p <= 0) {
+    return 0;
+  }
+  if (p >= 1) {
+    return n;
+  }
+  if (p > 0.5) {
+    return n - randomBinomial(random, n, 1 - p);
+  }
+  return n * p < 10 ? binomialInversion(random, n, p)
+                    : binomialRejection(random, n, p);
+}
+
+// 把 n 次试验按等概率分到 count 个类别，即多项分布的逐项条件二项抽样
+void randomMultinomial(Random *random, int n, int *counts, int count) {
+  for (int i = 0; i < count - 1; ++i) {
+    counts[i] = randomBinomial(random, n, 1.0 / (count - i));
+    n -= counts[i];
+  }
+  counts[count - 1] = n;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// xoshiro256**，状态只属于调用方，多线程之间互不干扰
+typedef struct {
+  uint64_t state[4];
+  uint64_t mirror; // 全 1 时输出按位取反，得到 u 与 1 - u 对应的对偶序列
+} Random;
+
+extern void seedRandom(Random *random, uint64_t seed);
+extern void seedRandomStream(Random *random, uint64_t seed, uint64_t stream);
+extern void jumpRandom(Random *random);
+extern void mirrorRandom(Random *random);
+extern uint64_t nextRandom64(Random *random);
+extern uint32_t nextRandom(Random *random);
+extern int randomBelow(Random *random, int bound);
+extern double randomUnit(Random *random);
+extern int randomBinomial(Random *random, int n, double p);
+extern void randomMultinomial(Random *random, int n, int *counts, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RANDOM_H
\ No newline at end of file
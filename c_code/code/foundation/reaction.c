@@ -0,0 +1,23 @@
+#include "reaction.h"
+
+void initReactionDepth(ReactionDepth *reactions, int chainLimit) {
+  reactions->depth = 0;
+  reactions->chainLimit = chainLimit;
+  reactions->dropped = 0;
+}
+
+// 进入下一层反击，超过链长上限时计入 dropped 并返回 0
+int enterReaction(ReactionDepth *reactions) {
+  if (reactions->depth >= reactions->chainLimit) {
+    reactions->dropped++;
+    return 0;
+  }
+  reactions->depth++;
+  return 1;
+}
+
+void leaveReaction(ReactionDepth *reactions) {
+  if (reactions->depth > 0) {
+    reactions->depth--;
+  }
+}
\ No newline at end of file
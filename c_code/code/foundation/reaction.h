@@ -0,0 +1,28 @@
+#ifndef REACTION_H
+#define REACTION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// 默认反击链长度上限，第 n 层反击由第 n-1 层反击造成的伤害触发
+#define REACTION_CHAIN_LIMIT 8
+
+// 反击按调用顺序直接递归结算，这里只记录递归的层数，超过上限的反击被丢弃
+typedef struct {
+  int depth;      // 正在结算的反击层数，0 表示不在反击中
+  int chainLimit; // 超过此层数的反击被丢弃
+  uint64_t dropped;
+} ReactionDepth;
+
+extern void initReactionDepth(ReactionDepth *reactions, int chainLimit);
+extern int enterReaction(ReactionDepth *reactions);
+extern void leaveReaction(ReactionDepth *reactions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REACTION_H
\ No newline at end of file
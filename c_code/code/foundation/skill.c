@@ -0,0 +1,283 @@
+#include <stddef.h>
+
+#include "skill.h"
+
+// 永久效果，与 Flutter 端被动技能的 type、value 赋值一致
+static void setInfiniteEffect(Energy *energy, EffectID id, double value) {
+  energy->effects[id].type = infinite;
+  energy->effects[id].value = value;
+  energy->activeEffects |= EFFECT_BIT(id);
+}
+
+// 叠加一次效果，与 Flutter 端主动技能的 value 赋值、times 累加一致
+static void stackEffect(Energy *energy, EffectID id, double value, int times) {
+  energy->effects[id].value = value;
+  setEffectTimes(energy, id, energy->effects[id].times + times);
+}
+
+static void handleParry(SkillBook *book, Energy *energy) {
+  stackEffect(energy, parryState, 0.75, 1);
+}
+
+static void handleMetalPassive0(SkillBook *book, Energy *energy) {
+  setInfiniteEffect(energy, strengthen, 0.5);
+}
+
+static void handleWaterPassive0(SkillBook *book, Energy *energy) {
+  setInfiniteEffect(energy, adjustAttribute, 0.75);
+}
+
+static void handleWoodPassive0(SkillBook *book, Energy *energy) {
+  setInfiniteEffect(energy, absorbBlood, 0.25);
+}
+
+static void handleFirePassive0(SkillBook *book, Energy *energy) {
+  setInfiniteEffect(energy, enchanting, 1.0);
+}
+
+static void handleEarthPassive0(SkillBook *book, Energy *energy) {
+  setInfiniteEffect(energy, accumulateAnger, 0.5);
+}
+
+static void handleMetalActive0(SkillBook *book, Energy *energy) {
+  stackEffect(energy, multipleHit, 1, 1);
+}
+
+static void handleWaterActive0(SkillBook *book, Energy *energy) {
+  stackEffect(energy, weakenAttack, 0.5, 2);
+}
+
+static void handleWoodActive0(SkillBook *book, Energy *energy) {
+  stackEffect(energy, restoreLife, 0.125, 1);
+}
+
+static void handleFireActive0(SkillBook *book, Energy *energy) {
+  stackEffect(energy, sacrificing, 1, 1);
+}
+
+static void handleEarthActive0(SkillBook *book, Energy *energy) {
+  stackEffect(energy, revengeAtonce, 1, 1);
+}
+
+// 被动1：主动0可以施加给己方任一灵根
+static void handleSelfAnyPassive1(SkillBook *book, Energy *energy) {
+  if (book) {
+    book->targets[SKILL_SLOT_ACTIVE] = SKILL_SELF_ANY;
+  }
+}
+
+// 水泄不通：拖泥带水可以施加给敌方任一灵根
+static void handleEnemyAnyPassive1(SkillBook *book, Energy *energy) {
+  if (book) {
+    book->targets[SKILL_SLOT_ACTIVE] = SKILL_ENEMY_ANY;
+  }
+}
+
+static void handleMetalActive1(SkillBook *book, Energy *energy) {
+  stackEffect(energy, strengthen, 0.5, 2);
+}
+
+static void handleWaterActive1(SkillBook *book, Energy *energy) {
+  stackEffect(energy, adjustAttribute, 0.75, 2);
+}
+
+static void handleWoodActive1(SkillBook *book, Energy *energy) {
+  stackEffect(energy, absorbBlood, 0.25, 2);
+}
+
+static void handleFireActive1(SkillBook *book, Energy *energy) {
+  stackEffect(energy, enchanting, 1.0, 2);
+}
+
+static void handleEarthActive1(SkillBook *book, Energy *energy) {
+  stackEffect(energy, accumulateAnger, 0.5, 2);
+}
+
+static void handleMetalActive2(SkillBook *book, Energy *energy) {
+  stackEffect(energy, giantKiller, 0.25, 1);
+}
+
+static void handleWaterActive2(SkillBook *book, Energy *energy) {
+  stackEffect(energy, exemptionDeath, 1, 1);
+}
+
+static void handleWoodActive2(SkillBook *book, Energy *energy) {
+  stackEffect(energy, increaseCapacity, 1, 1);
+}
+
+static void handleFireActive2(SkillBook *book, Energy *energy) {
+  stackEffect(energy, hotDamage, 0.25, 2);
+}
+
+static void handleEarthActive2(SkillBook *book, Energy *energy) {
+  stackEffect(energy, rugged, 0.25, 2);
+}
+
+// 常量初始化的技能表，按技能编号直接索引
+const CombatSkill skillCollection[SKILL_ID_COUNT] = {
+    [parry] = {parry, SKILL_ACTIVE, SKILL_SELF_ANY, "格挡",
+               "防守时，减少75%伤害，生效一次。", handleParry},
+
+    [metalPassive_0] = {metalPassive_0, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "武器大师", "战斗时，额外获得50%的攻击力和防御力。",
+                        handleMetalPassive0},
+    [waterPassive_0] = {waterPassive_0, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "因地制流",
+                        "受到伤害后，防御力减少，根据减少量的75%，提高攻击力，"
+                        "并获取法术伤害的附魔。",
+                        handleWaterPassive0},
+    [woodPassive_0] = {woodPassive_0, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                       "叶落归根", "造成伤害后，根据伤害量的25%，回复生命。",
+                       handleWoodPassive0},
+    [firePassive_0] = {firePassive_0, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                       "燃烧吧",
+                       "攻击时，获得100%附魔比例，造成无视防御的法术伤害。",
+                       handleFirePassive0},
+    [earthPassive_0] = {earthPassive_0, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "厚积薄发",
+                        "受到伤害后，将物理伤害的50%和法术伤害的15%作为加成，"
+                        "提高下次攻击的攻击力。",
+                        handleEarthPassive0},
+
+    [metalActive_0] = {metalActive_0, SKILL_ACTIVE, SKILL_SELF_FRONT,
+                       "双重打击", "下次攻击时，额外进行一次，生效一次。",
+                       handleMetalActive0},
+    [waterActive_0] = {waterActive_0, SKILL_ACTIVE, SKILL_ENEMY_FRONT,
+                       "拖泥带水", "下次攻击时，减少50%的攻击力，生效两次。",
+                       handleWaterActive0},
+    [woodActive_0] = {woodActive_0, SKILL_ACTIVE, SKILL_SELF_FRONT, "根深蒂固",
+                      "根据自身生命上限的12.5%的回复生命，生效一次。",
+                      handleWoodActive0},
+    [fireActive_0] = {fireActive_0, SKILL_ACTIVE, SKILL_SELF_FRONT, "爆裂魔法",
+                      "生命值降为1，根据降低的比例，提高伤害系数，"
+                      "并进行一次攻击。",
+                      handleFireActive0},
+    [earthActive_0] = {earthActive_0, SKILL_ACTIVE, SKILL_SELF_FRONT,
+                       "不动如山", "下次受到伤害时，进行一次攻击。",
+                       handleEarthActive0},
+
+    [metalPassive_1] = {metalPassive_1, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "攻守易形",
+                        "双重打击可以施加给己方任一灵根，使其下次攻击时，"
+                        "额外进行一次。",
+                        handleSelfAnyPassive1},
+    [waterPassive_1] = {waterPassive_1, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "水泄不通",
+                        "拖泥带水可以施加给敌方任一灵根，使其下次攻击时，"
+                        "减少50%的攻击力，生效两次。",
+                        handleEnemyAnyPassive1},
+    [woodPassive_1] = {woodPassive_1, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                       "开枝散叶",
+                       "根深蒂固可以施加给己方任一灵根，"
+                       "根据自身生命上限的12.5%的回复其生命。",
+                       handleSelfAnyPassive1},
+    [firePassive_1] = {firePassive_1, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                       "薪火相传",
+                       "爆裂魔法可以施加给己方任一灵根，使其攻击时，"
+                       "获得100%附魔比例，造成无视防御的法术伤害。"
+                       "并在生效后，切换其上场。",
+                       handleSelfAnyPassive1},
+    [earthPassive_1] = {earthPassive_1, SKILL_PASSIVE, SKILL_SELF_FRONT,
+                        "无懈可击",
+                        "不动如山可以施加给己方任一灵根，使其下次受到伤害时，"
+                        "进行一次攻击。",
+                        handleSelfAnyPassive1},
+
+    [metalActive_1] = {metalActive_1, SKILL_ACTIVE, SKILL_SELF_ANY, "金属颤音",
+                       "战斗时，额外获得50%的攻击力和防御力，生效两次。",
+                       handleMetalActive1},
+    [waterActive_1] = {waterActive_1, SKILL_ACTIVE, SKILL_SELF_ANY, "水无常形",
+                       "受到伤害后，防御力减少，根据减少量的75%，"
+                       "提高攻击力，生效两次。",
+                       handleWaterActive1},
+    [woodActive_1] = {woodActive_1, SKILL_ACTIVE, SKILL_SELF_ANY, "移花接木",
+                      "造成伤害时，根据伤害量的25%，回复生命，生效两次。",
+                      handleWoodActive1},
+    [fireActive_1] = {fireActive_1, SKILL_ACTIVE, SKILL_SELF_ANY, "火力全开",
+                      "攻击时，获得100%附魔比例，造成无视防御的法术伤害，"
+                      "生效两次。",
+                      handleFireActive1},
+    [earthActive_1] = {earthActive_1, SKILL_ACTIVE, SKILL_SELF_ANY, "卷土重来",
+                       "受到伤害后，将物理伤害的50%和法术伤害的15%作为加成，"
+                       "提高下次攻击的攻击力，生效两次。",
+                       handleEarthActive1},
+
+    [metalActive_2] = {metalActive_2, SKILL_ACTIVE, SKILL_SELF_FRONT,
+                       "巨人杀手",
+                       "攻击时，基于敌方当前生命值的25%，提高自身攻击力，"
+                       "生效一次。",
+                       handleMetalActive2},
+    [waterActive_2] = {waterActive_2, SKILL_ACTIVE, SKILL_SELF_FRONT, "止水",
+                       "受到致命伤害时，生命值回复到1，生效一次。",
+                       handleWaterActive2},
+    [woodActive_2] = {woodActive_2, SKILL_ACTIVE, SKILL_SELF_FRONT, "桎梏",
+                      "回复生命时，溢出治疗量会提升生命值上限，生效一次。",
+                      handleWoodActive2},
+    [fireActive_2] = {fireActive_2, SKILL_ACTIVE, SKILL_SELF_FRONT, "灼烧",
+                      "造成的法术伤害，会使敌人烧伤，使其再次受到伤害时，"
+                      "将会追加本次伤害25%的伤害，生效两次。",
+                      handleFireActive2},
+    [earthActive_2] = {earthActive_2, SKILL_ACTIVE, SKILL_SELF_FRONT, "砥砺",
+                       "受到伤害时，将已损失生命值的25%作为攻击力，"
+                       "造成一次伤害系数为25%的物理伤害，生效两次。",
+                       handleEarthActive2},
+};
+
+// 按 EnergyType 的顺序排列，Flutter 端 totalSkills 为金木水火土
+const SkillID elementSkills[ENERGY_COUNT][SKILL_SLOT_COUNT] = {
+    {metalPassive_0, metalActive_0, metalPassive_1, metalActive_1,
+     metalActive_2},
+    {waterPassive_0, waterActive_0, waterPassive_1, waterActive_1,
+     waterActive_2},
+    {woodPassive_0, woodActive_0, woodPassive_1, woodActive_1, woodActive_2},
+    {firePassive_0, fireActive_0, firePassive_1, fireActive_1, fireActive_2},
+    {earthPassive_0, earthActive_0, earthPassive_1, earthActive_1,
+     earthActive_2},
+};
+
+void initSkillBook(SkillBook *book, EnergyType type) {
+  book->type = type;
+  book->learned = 0;
+  for (int i = 0; i < SKILL_SLOT_COUNT; ++i) {
+    book->targets[i] = skillCollection[elementSkills[type][i]].target;
+  }
+}
+
+// 返回是否学习成功，槽位越界或已学习时失败
+int learnSkill(SkillBook *book, int slot) {
+  if (slot < 0 || slot >= SKILL_SLOT_COUNT || (book->learned & (1u << slot))) {
+    return 0;
+  }
+  book->learned |= 1u << slot;
+  return 1;
+}
+
+// 技能不属于该属性时使用技能表中的默认目标
+int skillTarget(const SkillBook *book, SkillID id) {
+  if (book) {
+    for (int i = 0; i < SKILL_SLOT_COUNT; ++i) {
+      if (elementSkills[book->type][i] == id) {
+        return book->targets[i];
+      }
+    }
+  }
+  return skillCollection[id].target;
+}
+
+// 与 Flutter 端 applyPassiveEffect 一致，只施加目标为所属灵根的被动
+void applyPassiveSkills(SkillBook *book, Energy *energy) {
+  for (int i = 0; i < SKILL_SLOT_COUNT; ++i) {
+    const CombatSkill *skill = &skillCollection[elementSkills[book->type][i]];
+    if ((book->learned & (1u << i)) && skill->type == SKILL_PASSIVE &&
+        book->targets[i] == SKILL_SELF_FRONT) {
+      skill->handler(book, energy);
+    }
+  }
+}
+
+// 对 energy 施放技能，调用方按 skillTarget 选择受术方
+void castSkill(SkillBook *book, SkillID id, Energy *energy) {
+  if (id < SKILL_ID_COUNT) {
+    skillCollection[id].handler(book, energy);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef SKILL_H
+#define SKILL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "energy.h"
+
+// 与 Flutter 端 SkillID 的顺序一致
+typedef enum {
+  parry,
+
+  metalPassive_0,
+  waterPassive_0,
+  woodPassive_0,
+  firePassive_0,
+  earthPassive_0,
+
+  metalActive_0,
+  waterActive_0,
+  woodActive_0,
+  fireActive_0,
+  earthActive_0,
+
+  metalPassive_1,
+  waterPassive_1,
+  woodPassive_1,
+  firePassive_1,
+  earthPassive_1,
+
+  metalActive_1,
+  waterActive_1,
+  woodActive_1,
+  fireActive_1,
+  earthActive_1,
+
+  metalActive_2,
+  waterActive_2,
+  woodActive_2,
+  fireActive_2,
+  earthActive_2,
+  SKILL_ID_COUNT
+} SkillID;
+
+typedef enum { SKILL_ACTIVE, SKILL_PASSIVE } SkillType;
+
+typedef enum {
+  SKILL_SELF_FRONT,
+  SKILL_SELF_ANY,
+  SKILL_ENEMY_FRONT,
+  SKILL_ENEMY_ANY,
+} SkillTarget;
+
+// 每个属性可学习的技能数，顺序为被动0、主动0、被动1、主动1、主动2
+#define SKILL_SLOT_COUNT 5
+// 主动0所在的槽位，即战斗中 SKILL 行动施放的技能
+#define SKILL_SLOT_ACTIVE 1
+
+// 一个属性已学习的技能，以及被被动技能改写后的目标类型
+typedef struct {
+  EnergyType type;
+  uint8_t learned; // 按槽位的位掩码
+  uint8_t targets[SKILL_SLOT_COUNT];
+} SkillBook;
+
+// book 只有改写目标类型的被动技能使用，其余技能可以传 NULL
+typedef void (*SkillHandler)(SkillBook *book, Energy *energy);
+
+typedef struct {
+  SkillID id;
+  SkillType type;
+  SkillTarget target;
+  const char *name;
+  const char *description;
+  SkillHandler handler;
+} CombatSkill;
+
+extern const CombatSkill skillCollection[SKILL_ID_COUNT];
+extern const SkillID elementSkills[ENERGY_COUNT][SKILL_SLOT_COUNT];
+
+extern void initSkillBook(SkillBook *book, EnergyType type);
+extern int learnSkill(SkillBook *book, int slot);
+extern int skillTarget(const SkillBook *book, SkillID id);
+extern void applyPassiveSkills(SkillBook *book, Energy *energy);
+extern void castSkill(SkillBook *book, SkillID id, Energy *energy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SKILL_H
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "energy.h"
+#include "trace.h"
+
+static const char *actorNames[2] = {"player", "enemy"};
+static const char *actionNames[] = {"ATTACK", "PARRY", "SKILL", "ESCAPE"};
+static const char *typeNames[TRACE_TYPE_COUNT] = {
+    "action", "damage", "recover", "sacrifice", "exemption", "counter"};
+
+// capacity 向上取整为 2 的幂
+int initTrace(TraceBuffer *trace, uint32_t capacity) {
+  uint32_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  trace->events = malloc(sizeof(TraceEvent) * size);
+  trace->mask = size - 1;
+  trace->head = 0;
+  trace->actors[0] = NULL;
+  trace->actors[1] = NULL;
+  return trace->events != NULL;
+}
+
+void freeTrace(TraceBuffer *trace) {
+  free(trace->events);
+  trace->events = NULL;
+}
+
+void beginTrace(TraceBuffer *trace, const void *player, const void *enemy) {
+  trace->head = 0;
+  trace->actors[0] = player;
+  trace->actors[1] = enemy;
+}
+
+void appendTrace(TraceBuffer *trace, TraceType type, const void *actor,
+                 int detail, int value, int health) {
+  TraceEvent *event = &trace->events[trace->head++ & trace->mask];
+  event->type = type;
+  event->actor = actor != trace->actors[0];
+  event->detail = detail;
+  event->reserved = 0;
+  event->value = value;
+  event->health = health;
+}
+
+void writeTraceHeader(FILE *file) {
+  TraceFileHeader header = {.magic = TRACE_MAGIC,
+                            .version = TRACE_VERSION,
+                            .eventSize = sizeof(TraceEvent)};
+  fwrite(&header, sizeof(header), 1, file);
+}
+
+// 按时间顺序写出缓冲区中保留的事件
+void writeTrace(const TraceBuffer *trace, FILE *file, uint64_t index,
+                int playerType, int enemyType, int result) {
+  uint64_t capacity = (uint64_t)trace->mask + 1;
+  uint64_t count = trace->head < capacity ? trace->head : capacity;
+  TraceRecord record = {.index = index,
+                        .playerType = playerType,
+                        .enemyType = enemyType,
+                        .result = result,
+                        .count = count,
+                        .dropped = trace->head - count};
+  fwrite(&record, sizeof(record), 1, file);
+
+  uint64_t start = (trace->head - count) & trace->mask;
+  uint64_t first = count < capacity - start ? count : capacity - start;
+  fwrite(&trace->events[start], sizeof(TraceEvent), first, file);
+  fwrite(trace->events, sizeof(TraceEvent), count - first, file);
+}
+
+static int reserveTraceChunk(TraceChunk *chunk, size_t size) {
+  if (chunk->size + size <= chunk->capacity) {
+    return 1;
+  }
+  size_t capacity = chunk->capacity ? chunk->capacity : 4096;
+  while (capacity < chunk->size + size) {
+    capacity *= 2;
+  }
+  uint8_t *data = realloc(chunk->data, capacity);
+  if (data == NULL) {
+    return 0;
+  }
+  chunk->data = data;
+  chunk->capacity = capacity;
+  return 1;
+}
+
+// 与 writeTrace 相同的记录追加到内存中，内存不足时返回 0
+int packTrace(TraceChunk *chunk, const TraceBuffer *trace, uint64_t index,
+              int playerType, int enemyType, int result) {
+  uint64_t capacity = (uint64_t)trace->mask + 1;
+  uint64_t count = trace->head < capacity ? trace->head : capacity;
+  if (!reserveTraceChunk(chunk, sizeof(TraceRecord) +
+                                    count * sizeof(TraceEvent))) {
+    return 0;
+  }
+  TraceRecord record = {.index = index,
+                        .playerType = playerType,
+                        .enemyType = enemyType,
+                        .result = result,
+                        .count = count,
+                        .dropped = trace->head - count};
+  memcpy(chunk->data + chunk->size, &record, sizeof(record));
+  chunk->size += sizeof(record);
+
+  uint64_t start = (trace->head - count) & trace->mask;
+  uint64_t first = count < capacity - start ? count : capacity - start;
+  memcpy(chunk->data + chunk->size, &trace->events[start],
+         first * sizeof(TraceEvent));
+  chunk->size += first * sizeof(TraceEvent);
+  memcpy(chunk->data + chunk->size, trace->events,
+         (count - first) * sizeof(TraceEvent));
+  chunk->size += (count - first) * sizeof(TraceEvent);
+  return 1;
+}
+
+// 写出并清空，保留已分配的内存
+void flushTraceChunk(TraceChunk *chunk, FILE *file) {
+  if (chunk->size) {
+    fwrite(chunk->data, 1, chunk->size, file);
+  }
+  chunk->size = 0;
+}
+
+void freeTraceChunk(TraceChunk *chunk) {
+  free(chunk->data);
+  chunk->data = NULL;
+  chunk->size = chunk->capacity = 0;
+}
+
+static void printEventText(FILE *out, const TraceEvent *event) {
+  const char *name = actorNames[event->actor & 1];
+
+  switch (event->type) {
+  case TRACE_ACTION:
+    fprintf(out, "%s chose %s\n", name,
+            event->value >= 0 && event->value < 4 ? actionNames[event->value]
+                                                  : "UNKNOWN");
+    break;
+  case TRACE_DAMAGE:
+    fprintf(out, "%s 受到 %d %s 伤害, 当前生命值为 %d\n", name, event->value,
+            event->detail ? "⚡法术" : "🗡️物理", event->health);
+    break;
+  case TRACE_RECOVER:
+    fprintf(out, "%s 回复了 %d 生命值❤️‍🩹, 当前生命值为 %d\n", name,
+            event->value, event->health);
+    break;
+  case TRACE_SACRIFICE:
+    fprintf(out, "%s 对自身造成 %d ⚡法术伤害, 当前生命值为 %d\n", name,
+            event->value, event->health);
+    break;
+  case TRACE_EXEMPTION:
+    fprintf(out, "%s 免疫了死亡, 当前生命值为 %d\n", name, event->health);
+    break;
+  case TRACE_COUNTER:
+    fprintf(out, "%s 发动%s\n", name, event->detail ? "立即反击" : "坚韧反伤");
+    break;
+  default:
+    fprintf(out, "%s unknown event %d\n", name, event->type);
+    break;
+  }
+}
+
+// 离线解码二进制轨迹文件，输出中文文本或 CSV
+int decodeTrace(FILE *in, FILE *out, TraceFormat format) {
+  TraceFileHeader header;
+  if (fread(&header, sizeof(header), 1, in) != 1 ||
+      header.magic != TRACE_MAGIC || header.version != TRACE_VERSION ||
+      header.eventSize != sizeof(TraceEvent)) {
+    return -1;
+  }
+
+  if (format == TRACE_CSV) {
+    fprintf(out, "battle,player,enemy,result,event,actor,detail,value,"
+                 "health\n");
+  }
+
+  TraceRecord record;
+  TraceEvent event;
+  while (fread(&record, sizeof(record), 1, in) == 1) {
+    if (format == TRACE_TEXT) {
+      fprintf(out, "battle %llu: %s vs %s\n", (unsigned long long)record.index,
+              energyNames[record.playerType % ENERGY_COUNT],
+              energyNames[record.enemyType % ENERGY_COUNT]);
+      if (record.dropped) {
+        fprintf(out, "... %llu earlier events dropped\n",
+                (unsigned long long)record.dropped);
+      }
+    }
+
+    for (uint32_t i = 0; i < record.count; ++i) {
+      if (fread(&event, sizeof(event), 1, in) != 1) {
+        return -1;
+      }
+      if (format == TRACE_CSV) {
+        fprintf(out, "%llu,%d,%d,%d,%s,%s,%d,%d,%d\n",
+                (unsigned long long)record.index, record.playerType,
+                record.enemyType, record.result,
+                event.type < TRACE_TYPE_COUNT ? typeNames[event.type] : "?",
+                actorNames[event.actor & 1], event.detail, event.value,
+                event.health);
+      } else {
+        printEventText(out, &event);
+      }
+    }
+
+    if (format == TRACE_TEXT) {
+      fprintf(out, "result: %d\n\n", record.result);
+    }
+  }
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define TRACE_MAGIC 0x52544245 // "EBTR"
+#define TRACE_VERSION 1
+
+typedef enum {
+  TRACE_ACTION,    // 选择行为，value 为 Action
+  TRACE_DAMAGE,    // 受到伤害，detail 为伤害类型
+  TRACE_RECOVER,   // 回复生命值
+  TRACE_SACRIFICE, // 牺牲自身生命值
+  TRACE_EXEMPTION, // 免疫死亡
+  TRACE_COUNTER,   // 反击，detail 0 为坚韧反伤，1 为立即反击
+  TRACE_TYPE_COUNT
+} TraceType;
+
+// 定长二进制事件，热路径上只做一次结构体写入
+typedef struct {
+  uint8_t type;
+  uint8_t actor; // 0 为玩家，1 为敌人
+  uint8_t detail;
+  uint8_t reserved;
+  int32_t value;
+  int32_t health; // 事件发生后 actor 的生命值
+} TraceEvent;
+
+// 每场对局的环形缓冲区，容量为 2 的幂，写满后覆盖最早的事件
+typedef struct TraceBuffer {
+  TraceEvent *events;
+  uint32_t mask;
+  uint64_t head; // 已写入的事件总数
+  const void *actors[2];
+} TraceBuffer;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t eventSize;
+  uint32_t reserved;
+} TraceFileHeader;
+
+typedef struct {
+  uint64_t index; // 对局编号
+  uint8_t playerType;
+  uint8_t enemyType;
+  int8_t result;
+  uint8_t reserved;
+  uint32_t count;   // 随后的事件数
+  uint64_t dropped; // 因缓冲区覆盖而丢弃的事件数
+} TraceRecord;
+
+typedef enum { TRACE_TEXT, TRACE_CSV } TraceFormat;
+
+// 暂存在内存中的若干场轨迹，格式与文件中相同，确定保留后整体写出
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+} TraceChunk;
+
+// 上下文未挂载缓冲区时只有一次判空
+#define TRACE_EVENT(ctx, type, actor, detail, value, health)                   \
+  do {                                                                         \
+    if ((ctx)->trace) {                                                        \
+      appendTrace((ctx)->trace, type, actor, detail, value, health);           \
+    }                                                                          \
+  } while (0)
+
+extern int initTrace(TraceBuffer *trace, uint32_t capacity);
+extern void freeTrace(TraceBuffer *trace);
+extern void beginTrace(TraceBuffer *trace, const void *player,
+                       const void *enemy);
+extern void appendTrace(TraceBuffer *trace, TraceType type, const void *actor,
+                        int detail, int value, int health);
+extern void writeTraceHeader(FILE *file);
+extern void writeTrace(const TraceBuffer *trace, FILE *file, uint64_t index,
+                       int playerType, int enemyType, int result);
+extern int packTrace(TraceChunk *chunk, const TraceBuffer *trace,
+                     uint64_t index, int playerType, int enemyType,
+                     int result);
+extern void flushTraceChunk(TraceChunk *chunk, FILE *file);
+extern void freeTraceChunk(TraceChunk *chunk);
+extern int decodeTrace(FILE *in, FILE *out, TraceFormat format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
\ No newline at end of file
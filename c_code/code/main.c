@@ -1,12 +1,98 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "run.h"
+#include "solver.h"
 
 int main(int argc, char **argv) {
   system("chcp 65001");
 
   if (argc == 1) {
     runSimulation();
+  } else if (strcmp(argv[1], "sim") == 0) {
+    // sim [每组场数] [线程数] [等级] [种子] [轨迹文件] [敌人变体数] [预设文件]
+    //     [胜率误差 %]
+    // 轨迹文件、预设文件为 - 时不使用，给出胜率误差时每组场数为上限
+    runMonteCarlo(argc > 2 ? atoll(argv[2]) : 100000,
+                  argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : 0,
+                  argc > 5 ? strtoull(argv[5], NULL, 10) : 0,
+                  argc > 6 && strcmp(argv[6], "-") != 0 ? argv[6] : NULL,
+                  argc > 7 ? atoi(argv[7]) : 0,
+                  argc > 8 && strcmp(argv[8], "-") != 0 ? argv[8] : NULL,
+                  argc > 9 ? atof(argv[9]) / 100 : 0);
+  } else if (strcmp(argv[1], "ab") == 0 && argc > 2) {
+    // ab <候选预设> [每组场数] [线程数] [等级] [种子] [基准预设] [对偶]
+    // 基准预设为 - 时使用默认预设，对偶为 1 时每场再加一场对偶序列
+    runComparison(argv[2], argc > 3 ? atoll(argv[3]) : 100000,
+                  argc > 4 ? atoi(argv[4]) : 0, argc > 5 ? atoi(argv[5]) : 0,
+                  argc > 6 ? strtoull(argv[6], NULL, 10) : 0,
+                  argc > 7 && strcmp(argv[7], "-") != 0 ? argv[7] : NULL,
+                  argc > 8 && atoi(argv[8]) != 0);
+  } else if (strcmp(argv[1], "ai") == 0) {
+    // ai [每组场数] [每步微秒] [等级] [种子] [线程数] [每步节点数]
+    // 给定种子时按节点数截止，每步微秒不再生效
+    runEnemySearch(argc > 2 ? atoll(argv[2]) : 200,
+                   argc > 3 ? atoi(argv[3]) : 20, argc > 4 ? atoi(argv[4]) : 0,
+                   argc > 5 ? strtoull(argv[5], NULL, 10) : 0,
+                   argc > 6 ? atoi(argv[6]) : 0, argc > 7 ? atoi(argv[7]) : 0);
+  } else if (strcmp(argv[1], "team") == 0) {
+    // team [每组场数] [等级] [种子]
+    runTeamTournament(argc > 2 ? atoll(argv[2]) : 100,
+                      argc > 3 ? atoi(argv[3]) : 0,
+                      argc > 4 ? strtoull(argv[4], NULL, 10) : 0);
+  } else if (strcmp(argv[1], "balance") == 0) {
+    // balance [每组场数] [评估次数] [种子] [检查点文件] [目标文件]
+    // 检查点文件为 - 时不保存
+    runBalance(argc > 2 ? atoll(argv[2]) : 2000,
+               argc > 3 ? atoll(argv[3]) : 1000,
+               argc > 4 ? strtoull(argv[4], NULL, 10) : 0,
+               argc > 5 && strcmp(argv[5], "-") != 0 ? argv[5] : NULL,
+               argc > 6 ? argv[6] : NULL);
+  } else if (strcmp(argv[1], "presets") == 0 && argc > 2) {
+    // presets <预设文件> [default]，带 default 时写出默认预设
+    runPresets(argv[2], argc > 3 && strcmp(argv[3], "default") == 0);
+  } else if (strcmp(argv[1], "grid") == 0) {
+    // grid [每格场数] [最高等级] [等级间隔] [种子] [热力图文件] [线程数]
+    //      [预设文件]
+    // 热力图文件、预设文件为 - 时不使用
+    runLevelTournament(
+        argc > 2 ? atoll(argv[2]) : 100, argc > 3 ? atoi(argv[3]) : 100,
+        argc > 4 ? atoi(argv[4]) : 10,
+        argc > 5 ? strtoull(argv[5], NULL, 10) : 0,
+        argc > 6 ? (strcmp(argv[6], "-") != 0 ? argv[6] : NULL) : "grid.bin",
+        argc > 7 ? atoi(argv[7]) : 0,
+        argc > 8 && strcmp(argv[8], "-") != 0 ? argv[8] : NULL);
+  } else if (strcmp(argv[1], "solve") == 0) {
+    // solve [等级] [种子] [内存 MB] [截断概率]
+    // 截断概率为 0 时完全展开，状态数随回合数指数增长，通常无法完成
+    // 有格子截断的概率超过截断概率时返回 1
+    int solved = runSolver(argc > 2 ? atoi(argv[2]) : 0,
+                           argc > 3 ? strtoull(argv[3], NULL, 10) : 0,
+                           argc > 4 ? atoi(argv[4]) : 64,
+                           argc > 5 ? atof(argv[5]) : SOLVER_CUTOFF);
+    return solved ? 0 : 1;
+  } else if (strcmp(argv[1], "profile") == 0) {
+    // profile [每组场数] [等级] [种子]
+    runProfile(argc > 2 ? atoll(argv[2]) : 10000, argc > 3 ? atoi(argv[3]) : 0,
+               argc > 4 ? strtoull(argv[4], NULL, 10) : 0);
+  } else if (strcmp(argv[1], "batch") == 0) {
+    // batch [对局数] [等级]，对比特化内核、批量路径与通用路径
+    runBatchBenchmark(argc > 2 ? atoi(argv[2]) : 1000000,
+                      argc > 3 ? atoi(argv[3]) : 0);
+  } else if (strcmp(argv[1], "curve") == 0) {
+    // curve [采样数]
+    runCurveBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+  } else if (strcmp(argv[1], "decode") == 0 && argc > 2) {
+    // decode <轨迹文件> [csv]
+    runDecode(argv[2], argc > 3 && strcmp(argv[3], "csv") == 0);
+  } else if (strcmp(argv[1], "replay") == 0 && argc > 5) {
+    // replay <种子> <玩家> <敌人> <场次> [等级] [敌人 AI 每步节点数]
+    runReplay(strtoull(argv[2], NULL, 10), argc > 6 ? atoi(argv[6]) : 0,
+              atoi(argv[3]), atoi(argv[4]), atoll(argv[5]),
+              argc > 7 ? atoi(argv[7]) : 0);
+  } else if (strcmp(argv[1], "check") == 0) {
+    // check，与原实现逐项对比反击链、灵根切换等行为，不一致时返回 1
+    return runCheck() ? 0 : 1;
   } else if (argc == 2) {
     runInteractiveMode(atoi(argv[1]));
   } else if (argc > 2) {
@@ -4,11 +4,13 @@
 #include "action.h"
 #include "combat.h"
 #include "custom.h"
+#include "skill.h"
+#include "trace.h"
 
-Action getPlayerAction() {
+Action getPlayerAction(Context *ctx) {
   char command;
   customPrintf(
-      "Choose your action: a(attack), p(parry), s(skill), e(escape): ");
+      ctx, "Choose your action: a(attack), p(parry), s(skill), e(escape): ");
   scanf_s(" %c", &command);
 
   switch (command) {
@@ -21,19 +23,26 @@ Action getPlayerAction() {
   case 'e':
     return ESCAPE;
   default:
-    customPrintf("Invalid command. Default ATTACK.\n");
+    customPrintf(ctx, "Invalid command. Default ATTACK.\n");
     return ATTACK;
   }
 }
 
-Action getEnemyAction() {
-  float rand_num = (float)rand() / RAND_MAX;
-  if (rand_num < 0.8) {
-    return ATTACK;
-  } else if (rand_num < 0.9) {
+// 与 getEnemyAction 的分布一致，供精确求解使用
+const double enemyActionProbability[ACTION_COUNT] = {96 / 128.0, 15 / 128.0,
+                                                     16 / 128.0, 1 / 128.0};
+
+// 与 Flutter 端 CombatLogic 的敌人行为分布一致
+Action getEnemyAction(Context *ctx) {
+  int rand_num = randomBelow(&ctx->random, 128);
+  if (rand_num < 1) {
+    return ESCAPE;
+  } else if (rand_num < 16) {
     return PARRY;
-  } else {
+  } else if (rand_num < 32) {
     return SKILL;
+  } else {
+    return ATTACK;
   }
 }
 
@@ -53,22 +62,60 @@ const char *actionToString(Action action) {
   }
 }
 
-int handleAction(Energy *source, Energy *target, Action action) {
-  printAttributesBattle(source, target);
-
-  return handleCombat(source, target);
-  // switch (action) {
-
-  // case ATTACK:
-  //   return handleCombat(source, target);
-  // case PARRY:
-  //   return handleParry(source, target);
-  //   break;
-  // case SKILL:
-  //   return handleSkill(source, target);
-  // case ESCAPE:
-  //   return -2;
-  // default:
-  //   return 0;
-  // }
+typedef int (*ActionHandler)(Context *ctx, Energy *source, Energy *target);
+
+// 施放技能后的后续动作，主动0中只有根深蒂固与爆裂魔法需要立即战斗
+static int followWoodSkill(Context *ctx, Energy *source, Energy *target) {
+  // 对自身发起战斗，由即时效果回复生命
+  return handleCombat(ctx, source, source);
+}
+
+static int followFireSkill(Context *ctx, Energy *source, Energy *target) {
+  return handleCombat(ctx, source, target);
+}
+
+static const ActionHandler skillFollowers[ENERGY_COUNT] = {
+    [WOOD] = followWoodSkill, [FIRE] = followFireSkill};
+
+// 按技能的目标类型选择受术方
+static Energy *selectSkillTarget(SkillID id, Energy *source, Energy *target) {
+  int type = skillTarget(NULL, id);
+  return type == SKILL_ENEMY_FRONT || type == SKILL_ENEMY_ANY ? target
+                                                              : source;
+}
+
+static int handleAttackAction(Context *ctx, Energy *source, Energy *target) {
+  return handleCombat(ctx, source, target);
+}
+
+static int handleParryAction(Context *ctx, Energy *source, Energy *target) {
+  castSkill(NULL, parry, selectSkillTarget(parry, source, target));
+  return 0;
+}
+
+// 施放所属属性的主动0，即 Flutter 端 totalSkills[current][1]
+static int handleSkillAction(Context *ctx, Energy *source, Energy *target) {
+  SkillID id = elementSkills[source->type][SKILL_SLOT_ACTIVE];
+  castSkill(NULL, id, selectSkillTarget(id, source, target));
+  ActionHandler follower = skillFollowers[source->type];
+  return follower ? follower(ctx, source, target) : 0;
+}
+
+static int handleEscapeAction(Context *ctx, Energy *source, Energy *target) {
+  return -ACTION_ESCAPED;
+}
+
+static const ActionHandler actionHandlers[ACTION_COUNT] = {
+    handleAttackAction, handleParryAction, handleSkillAction,
+    handleEscapeAction};
+
+int handleAction(Context *ctx, Energy *source, Energy *target, Action action) {
+  TRACE_EVENT(ctx, TRACE_ACTION, source, 0, action, source->health);
+
+  if (LOG_ENABLED(ctx, LOG_DETAIL)) {
+    printAttributesBattle(ctx, source, target);
+  }
+
+  return action < ACTION_COUNT ? actionHandlers[action](ctx, source, target)
+                               : 0;
 }
\ No newline at end of file
@@ -5,14 +5,21 @@
 extern "C" {
 #endif
 
+#include "context.h"
 #include "energy.h"
 
 typedef enum { ATTACK, PARRY, SKILL, ESCAPE, ACTION_COUNT } Action;
 
-extern Action getPlayerAction();
-extern Action getEnemyAction();
+// handleAction 返回 -ACTION_ESCAPED 表示出手方逃跑
+#define ACTION_ESCAPED 2
+
+extern const double enemyActionProbability[ACTION_COUNT];
+
+extern Action getPlayerAction(Context *ctx);
+extern Action getEnemyAction(Context *ctx);
 extern const char *actionToString(Action action);
-extern int handleAction(Energy *source, Energy *target, Action action);
+extern int handleAction(Context *ctx, Energy *source, Energy *target,
+                        Action action);
 
 #ifdef __cplusplus
 }
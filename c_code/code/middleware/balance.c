@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "balance.h"
+
+#define BALANCE_VERSION 2
+
+typedef struct {
+  double minimum;
+  double maximum;
+  double step;    // 初始步长
+  double minStep; // 步长减半到此为止
+} BalanceParam;
+
+// 生命、攻击、防御、被动数值的取值范围与步长
+static const BalanceParam balanceParams[4] = {
+    {16, 1024, 32, 4}, {4, 256, 8, 1}, {0, 256, 8, 1}, {0, 2, 0.25, 0.0125}};
+
+static const BalanceParam schemeParam = {0, CURVE_COUNT - 1, 1, 1};
+
+static const BalanceParam *getParam(int dimension) {
+  return dimension < ENERGY_COUNT * 4 ? &balanceParams[dimension % 4]
+                                      : &schemeParam;
+}
+
+static double getValue(const BalanceState *state, int dimension) {
+  if (dimension >= ENERGY_COUNT * 4) {
+    return state->scheme;
+  }
+  const ElementPreset *preset = &state->presets.elements[dimension / 4];
+  switch (dimension % 4) {
+  case 0:
+    return preset->capacityBase;
+  case 1:
+    return preset->attackBase;
+  case 2:
+    return preset->defenceBase;
+  default:
+    return preset->passiveValue;
+  }
+}
+
+static void setValue(BalanceState *state, int dimension, double value) {
+  if (dimension >= ENERGY_COUNT * 4) {
+    state->scheme = (CurveScheme)(int)value;
+    return;
+  }
+  ElementPreset *preset = &state->presets.elements[dimension / 4];
+  switch (dimension % 4) {
+  case 0:
+    preset->capacityBase = roundToInt(value);
+    break;
+  case 1:
+    preset->attackBase = roundToInt(value);
+    break;
+  case 2:
+    preset->defenceBase = roundToInt(value);
+    break;
+  default:
+    preset->passiveValue = value;
+    break;
+  }
+}
+
+// 默认目标为完全平衡，每组得分率都是 50%
+void initBalanceConfig(BalanceConfig *config) {
+  memset(config, 0, sizeof(BalanceConfig));
+  config->battles = 2000;
+  config->evaluations = 1000;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      config->targets[i][j] = 0.5;
+    }
+  }
+}
+
+// 目标文件为 5 行 5 列的得分率 (0-1)，行为玩家属性
+int loadBalanceTargets(BalanceConfig *config, const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return 0;
+  }
+  int count = 0;
+  while (count < ENERGY_COUNT * ENERGY_COUNT &&
+         fscanf(file, "%lf", &config->targets[count / ENERGY_COUNT]
+                                              [count % ENERGY_COUNT]) == 1) {
+    count++;
+  }
+  fclose(file);
+  return count == ENERGY_COUNT * ENERGY_COUNT;
+}
+
+void initBalanceState(BalanceState *state) {
+  memset(state, 0, sizeof(BalanceState));
+  state->presets = defaultPresets;
+  state->scheme = CURVE_DEFAULT;
+  for (int d = 0; d < BALANCE_PARAM_COUNT; ++d) {
+    state->steps[d] = getParam(d)->step;
+  }
+  state->loss = -1;
+  state->direction = 1;
+}
+
+// 先写临时文件再改名，中途被杀也不会留下半个检查点
+int saveBalanceState(const BalanceState *state, const char *path) {
+  char temporary[1024];
+  snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+  FILE *file = fopen(temporary, "w");
+  if (file == NULL) {
+    return 0;
+  }
+  fprintf(file, "balance %d\n", BALANCE_VERSION);
+  fprintf(file, "loss %.17g\n", state->loss);
+  fprintf(file, "evaluations %lld\n", state->evaluations);
+  fprintf(file, "dimension %d\n", state->dimension);
+  fprintf(file, "direction %d\n", state->direction);
+  fprintf(file, "stalled %d\n", state->stalled);
+  fprintf(file, "battles %lld\n", state->battles);
+  fprintf(file, "seed %llu\n", (unsigned long long)state->seed);
+  fprintf(file, "scheme %d\n", state->scheme);
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    const ElementPreset *preset = &state->presets.elements[i];
+    fprintf(file, "preset %d %d %d %d %.9g\n", preset->capacityBase,
+            preset->attackBase, preset->defenceBase, preset->passive,
+            preset->passiveValue);
+  }
+  for (int d = 0; d < BALANCE_PARAM_COUNT; ++d) {
+    fprintf(file, "step %.17g\n", state->steps[d]);
+  }
+  int ok = fclose(file) == 0;
+#ifdef _WIN32
+  remove(path); // Windows 下 rename 不覆盖已有文件
+#endif
+  return ok && rename(temporary, path) == 0;
+}
+
+int loadBalanceState(BalanceState *state, const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return 0;
+  }
+  BalanceState loaded;
+  initBalanceState(&loaded); // 检查点不含加点数值，沿用默认
+  int version = 0;
+  int scheme = 0;
+  unsigned long long seed = 0;
+  int ok = fscanf(file, " balance %d", &version) == 1 &&
+           version == BALANCE_VERSION &&
+           fscanf(file, " loss %lf", &loaded.loss) == 1 &&
+           fscanf(file, " evaluations %lld", &loaded.evaluations) == 1 &&
+           fscanf(file, " dimension %d", &loaded.dimension) == 1 &&
+           fscanf(file, " direction %d", &loaded.direction) == 1 &&
+           fscanf(file, " stalled %d", &loaded.stalled) == 1 &&
+           fscanf(file, " battles %lld", &loaded.battles) == 1 &&
+           fscanf(file, " seed %llu", &seed) == 1 &&
+           fscanf(file, " scheme %d", &scheme) == 1;
+  for (int i = 0; ok && i < ENERGY_COUNT; ++i) {
+    ElementPreset *preset = &loaded.presets.elements[i];
+    int passive = 0;
+    ok = fscanf(file, " preset %d %d %d %d %f", &preset->capacityBase,
+                &preset->attackBase, &preset->defenceBase, &passive,
+                &preset->passiveValue) == 5 &&
+         passive >= 0 && passive < EFFECT_ID_COUNT;
+    preset->passive = passive;
+  }
+  for (int d = 0; ok && d < BALANCE_PARAM_COUNT; ++d) {
+    ok = fscanf(file, " step %lf", &loaded.steps[d]) == 1;
+  }
+  fclose(file);
+
+  if (!ok || scheme < 0 || scheme >= CURVE_COUNT || loaded.dimension < 0 ||
+      loaded.dimension >= BALANCE_PARAM_COUNT ||
+      (loaded.direction != 1 && loaded.direction != -1)) {
+    return 0;
+  }
+  loaded.scheme = scheme;
+  loaded.seed = seed;
+  *state = loaded;
+  return 1;
+}
+
+// 按目标得分率的平方误差之和评估一组参数
+double evaluateBalance(const BalanceConfig *config, const PresetTable *presets,
+                       CurveScheme scheme,
+                       MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  CurveConfig curve = {scheme, CURVE_TABLE};
+  SimulationConfig simulation = {.battles = config->battles,
+                                 .threads = config->threads,
+                                 .playerLevel = config->level,
+                                 .enemyLevel = config->level,
+                                 .seed = config->seed,
+                                 .presets = presets,
+                                 .curve = &curve};
+  simulateMatchups(&simulation, stats);
+
+  double loss = 0;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const MatchupStats *cell = &stats[i][j];
+      double score =
+          cell->count ? (cell->wins + cell->draws * 0.5) / cell->count : 0;
+      double error = score - config->targets[i][j];
+      loss += error * error;
+    }
+  }
+  return loss;
+}
+
+// 所有步长都已减到最小且一整轮没有改进时收敛
+static int halveSteps(BalanceState *state) {
+  int changed = 0;
+  for (int d = 0; d < BALANCE_PARAM_COUNT; ++d) {
+    const BalanceParam *param = getParam(d);
+    if (state->steps[d] > param->minStep) {
+      state->steps[d] /= 2;
+      if (state->steps[d] < param->minStep) {
+        state->steps[d] = param->minStep;
+      }
+      changed = 1;
+    }
+  }
+  return changed;
+}
+
+// 坐标搜索：依次沿每个参数正反各走一步，更好就接受，一整轮无改进则步长减半
+// 每个参数的两个方向都尝试过后写检查点，返回是否已经收敛
+int optimizeBalance(const BalanceConfig *config, BalanceState *state) {
+  MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT];
+  long long budget = config->evaluations;
+
+  if (state->loss < 0 || state->battles != config->battles ||
+      state->seed != config->seed) {
+    state->loss = evaluateBalance(config, &state->presets, state->scheme,
+                                  stats);
+    state->battles = config->battles;
+    state->seed = config->seed;
+    state->evaluations++;
+    budget--;
+  }
+
+  while (budget > 0) {
+    int d = state->dimension;
+    const BalanceParam *param = getParam(d);
+    double value = getValue(state, d);
+    int improved = 0;
+
+    for (; state->direction >= -1 && budget > 0; state->direction -= 2) {
+      double next = value + state->direction * state->steps[d];
+      if (next < param->minimum || next > param->maximum) {
+        continue;
+      }
+      BalanceState candidate = *state;
+      setValue(&candidate, d, next);
+      double loss = evaluateBalance(config, &candidate.presets,
+                                    candidate.scheme, stats);
+      state->evaluations++;
+      budget--;
+      if (loss < state->loss) {
+        setValue(state, d, next);
+        state->loss = loss;
+        improved = 1;
+        break;
+      }
+    }
+
+    if (!improved && state->direction >= -1) {
+      // 预算在正反两个方向之间用完，记下反方向，下次从这里继续
+      if (config->checkpointPath) {
+        saveBalanceState(state, config->checkpointPath);
+      }
+      return 0;
+    }
+
+    state->direction = 1;
+    state->stalled = improved ? 0 : state->stalled + 1;
+    state->dimension = (d + 1) % BALANCE_PARAM_COUNT;
+    printf("eval %6lld  param %2d  value %9.4f  step %8.4f  loss %.6f%s\n",
+           state->evaluations, d, getValue(state, d), state->steps[d],
+           state->loss, improved ? "  *" : "");
+    fflush(stdout);
+
+    int converged = 0;
+    if (state->stalled >= BALANCE_PARAM_COUNT) {
+      state->stalled = 0;
+      converged = !halveSteps(state);
+    }
+    if (config->checkpointPath) {
+      saveBalanceState(state, config->checkpointPath);
+    }
+    if (converged) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// 按 defaultPresets 的字段顺序输出，被动效果为 EffectID 的数值
+void printBalanceState(const BalanceState *state) {
+  printf("loss %.6f after %lld evaluations, curve %s\n", state->loss,
+         state->evaluations, curveNames[state->scheme]);
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    const ElementPreset *preset = &state->presets.elements[i];
+    printf("    [%d] = {%d, %d, %d, %d, %.4g},\n", i, preset->capacityBase,
+           preset->attackBase, preset->defenceBase, preset->passive,
+           preset->passiveValue);
+  }
+}
\ No newline at end of file
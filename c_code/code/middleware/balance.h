@@ -0,0 +1,56 @@
+#ifndef BALANCE_H
+#define BALANCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "attribute.h"
+#include "curve.h"
+#include "simulation.h"
+
+// 每个属性的生命、攻击、防御、被动数值，再加上调整属性曲线方案
+#define BALANCE_PARAM_COUNT (ENERGY_COUNT * 4 + 1)
+
+typedef struct {
+  long long battles; // 每次评估中每组对局的场数
+  int threads;       // 0 为按 CPU 核心数
+  int level;
+  long long evaluations; // 本次运行的评估次数上限
+  uint64_t seed; // 所有候选共用同一组随机序列，比较时噪声相互抵消
+  const char *checkpointPath; // 为空时不保存
+  double targets[ENERGY_COUNT][ENERGY_COUNT]; // 目标得分率，平局计半场
+} BalanceConfig;
+
+// 坐标搜索的全部状态，检查点保存的也就是它
+typedef struct {
+  PresetTable presets;
+  CurveScheme scheme;
+  double steps[BALANCE_PARAM_COUNT];
+  double loss; // 小于 0 表示当前参数尚未评估
+  long long evaluations;
+  int dimension; // 下一个尝试的参数
+  int direction; // 该参数下一个尝试的方向，1 或 -1
+  int stalled;   // 连续没有改进的参数个数
+  long long battles; // 计算 loss 时的场数与种子，与配置不同时需要重新评估
+  uint64_t seed;
+} BalanceState;
+
+extern void initBalanceConfig(BalanceConfig *config);
+extern int loadBalanceTargets(BalanceConfig *config, const char *path);
+extern void initBalanceState(BalanceState *state);
+extern int saveBalanceState(const BalanceState *state, const char *path);
+extern int loadBalanceState(BalanceState *state, const char *path);
+extern double evaluateBalance(const BalanceConfig *config,
+                              const PresetTable *presets, CurveScheme scheme,
+                              MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+extern int optimizeBalance(const BalanceConfig *config, BalanceState *state);
+extern void printBalanceState(const BalanceState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BALANCE_H
\ No newline at end of file
@@ -0,0 +1,442 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "battle.h"
+#include "kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BATCH_AVX2 1
+#endif
+
+// 每方的 int 数组和 float 数组个数，与 BatchSide 的字段对应
+#define SIDE_INT_ARRAYS 10
+#define SIDE_FLOAT_ARRAYS 3
+
+static int paddedCount(int count) {
+  return (count + BATCH_WIDTH - 1) / BATCH_WIDTH * BATCH_WIDTH;
+}
+
+// 从一整块内存中按 32 字节对齐切出数组
+static void *carve(char **cursor, size_t size) {
+  uintptr_t address = ((uintptr_t)*cursor + 31) & ~(uintptr_t)31;
+  *cursor = (char *)(address + size);
+  return (void *)address;
+}
+
+int initBatch(DuelBatch *batch, int capacity) {
+  memset(batch, 0, sizeof(DuelBatch));
+  if (capacity <= 0) {
+    return 0;
+  }
+
+  int lanes = paddedCount(capacity);
+  size_t intSize = sizeof(int) * lanes;
+  size_t floatSize = sizeof(float) * lanes;
+  size_t total = (intSize + 31) * (SIDE_INT_ARRAYS * 2 + 2) +
+                 (floatSize + 31) * SIDE_FLOAT_ARRAYS * 2;
+
+  batch->memory = calloc(1, total);
+  if (batch->memory == NULL) {
+    return 0;
+  }
+
+  char *cursor = batch->memory;
+  for (int s = 0; s < 2; ++s) {
+    BatchSide *side = &batch->side[s];
+    side->health = carve(&cursor, intSize);
+    side->capacityBase = carve(&cursor, intSize);
+    side->capacityExtra = carve(&cursor, intSize);
+    side->attackBase = carve(&cursor, intSize);
+    side->attackOffset = carve(&cursor, intSize);
+    side->defenceBase = carve(&cursor, intSize);
+    side->defenceOffset = carve(&cursor, intSize);
+    side->activeEffects = carve(&cursor, intSize);
+    side->physicsDamage = carve(&cursor, intSize);
+    side->magicDamage = carve(&cursor, intSize);
+    side->strengthen = carve(&cursor, floatSize);
+    side->enchanting = carve(&cursor, floatSize);
+    side->absorbBlood = carve(&cursor, floatSize);
+  }
+  batch->results = carve(&cursor, intSize);
+  batch->duels = carve(&cursor, intSize);
+
+  batch->capacity = capacity;
+  return 1;
+}
+
+void freeBatch(DuelBatch *batch) {
+  free(batch->memory);
+  memset(batch, 0, sizeof(DuelBatch));
+}
+
+// 效果全部为永久效果，附魔比例也无需截断时，出手不会改写任何效果
+static int canBatchEnergy(const Energy *energy) {
+  if (energy->activeEffects & ~BATCH_EFFECTS) {
+    return 0;
+  }
+  static const EffectID ids[] = {strengthen, enchanting, absorbBlood};
+  for (int i = 0; i < 3; ++i) {
+    if (EFFECT_ACTIVE(energy, ids[i]) &&
+        energy->effects[ids[i]].type != infinite) {
+      return 0;
+    }
+  }
+  float enchant = energy->effects[enchanting].value;
+  return !EFFECT_ACTIVE(energy, enchanting) || (enchant >= 0 && enchant <= 1);
+}
+
+static float activeValue(const Energy *energy, EffectID id) {
+  return EFFECT_ACTIVE(energy, id) ? energy->effects[id].value : 0;
+}
+
+static void loadSide(BatchSide *side, int lane, const Energy *energy) {
+  side->health[lane] = energy->health;
+  side->capacityBase[lane] = energy->capacityBase;
+  side->capacityExtra[lane] = energy->capacityExtra;
+  side->attackBase[lane] = energy->attackBase;
+  side->attackOffset[lane] = energy->attackOffset;
+  side->defenceBase[lane] = energy->defenceBase;
+  side->defenceOffset[lane] = energy->defenceOffset;
+  side->activeEffects[lane] = energy->activeEffects;
+  side->strengthen[lane] = activeValue(energy, strengthen);
+  side->enchanting[lane] = activeValue(energy, enchanting);
+  side->absorbBlood[lane] = activeValue(energy, absorbBlood);
+}
+
+// 追加一场对局，返回车道序号；批次已满或含有其他效果时返回 -1
+int addBatchLane(DuelBatch *batch, const Energy *player, const Energy *enemy) {
+  if (batch->count >= batch->capacity || !canBatchEnergy(player) ||
+      !canBatchEnergy(enemy)) {
+    return -1;
+  }
+  int lane = batch->count++;
+  loadSide(&batch->side[0], lane, player);
+  loadSide(&batch->side[1], lane, enemy);
+  return lane;
+}
+
+// 对局过程中只有生命值和额外生命上限会变化
+void storeBatchLane(const DuelBatch *batch, int lane, Energy *player,
+                    Energy *enemy) {
+  player->health = batch->side[0].health[lane];
+  player->capacityExtra = batch->side[0].capacityExtra[lane];
+  enemy->health = batch->side[1].health[lane];
+  enemy->capacityExtra = batch->side[1].capacityExtra[lane];
+}
+
+// 标量版本，按 handleCombat 的顺序求出攻击方每次出手的伤害
+static void prepareLane(BatchSide *attacker, const BatchSide *defender,
+                        int i) {
+  int attack = attacker->attackBase[i] + attacker->attackOffset[i];
+  attack += round(attack * attacker->strengthen[i]);
+  int defence = defender->defenceBase[i] + defender->defenceOffset[i];
+  defence += round(defence * defender->strengthen[i]);
+
+  double enchantRatio = attacker->enchanting[i];
+  double physicsAttack = attack * (1 - enchantRatio);
+  double magicAttack = attack * enchantRatio;
+
+  // 与 handleCalculateDamage 一致，系数恒为 1
+  if (physicsAttack > 0) {
+    attacker->physicsDamage[i] =
+        defence > 0
+            ? round(physicsAttack * (physicsAttack / (physicsAttack + defence)))
+            : round(physicsAttack - defence);
+  } else {
+    attacker->physicsDamage[i] = -1;
+  }
+  attacker->magicDamage[i] = magicAttack > 0 ? round(magicAttack) : -1;
+}
+
+// 与 handleDamage 一致，返回 1 表示防守方阵亡
+static int strikeLane(BatchSide *attacker, BatchSide *defender, int i,
+                      int damage, int damageType) {
+  if (damage < 0) {
+    return 0;
+  }
+
+  defender->health[i] -= damage;
+  if (defender->health[i] < 0) {
+    damage += defender->health[i];
+    defender->health[i] = 0;
+  }
+  defender->capacityExtra[i] -= damage;
+  if (defender->capacityExtra[i] < 0) {
+    defender->capacityExtra[i] = 0;
+  }
+
+  if (damageType == 0 &&
+      (attacker->activeEffects[i] & EFFECT_BIT(absorbBlood))) {
+    int capacity = attacker->capacityBase[i] + attacker->capacityExtra[i];
+    int recovery = round(damage * attacker->absorbBlood[i]);
+    attacker->health[i] += recovery;
+    if (attacker->health[i] > capacity) {
+      attacker->health[i] = capacity;
+    }
+  }
+  return defender->health[i] <= 0;
+}
+
+static void runLane(DuelBatch *batch, int i) {
+  BatchSide *player = &batch->side[0];
+  BatchSide *enemy = &batch->side[1];
+  prepareLane(player, enemy, i);
+  prepareLane(enemy, player, i);
+
+  for (int fightTimes = 0; fightTimes < BATTLE_ROUND_LIMIT; ++fightTimes) {
+    if (strikeLane(player, enemy, i, player->physicsDamage[i], 0) ||
+        strikeLane(player, enemy, i, player->magicDamage[i], 1) ||
+        strikeLane(enemy, player, i, enemy->physicsDamage[i], 0) ||
+        strikeLane(enemy, player, i, enemy->magicDamage[i], 1)) {
+      break;
+    }
+  }
+  batch->results[i] =
+      enemy->health[i] <= 0 ? player->health[i] : -enemy->health[i];
+}
+
+#ifdef BATCH_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+// 与 round() 一致的远离零取整
+AVX2 static inline __m256d roundAwayPd(__m256d x) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d truncated =
+      _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m256d fraction = _mm256_andnot_pd(sign, _mm256_sub_pd(x, truncated));
+  __m256d carry = _mm256_and_pd(
+      _mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ),
+      _mm256_or_pd(_mm256_and_pd(x, sign), _mm256_set1_pd(1.0)));
+  return _mm256_add_pd(truncated, carry);
+}
+
+// float 的积本身是 float，取整结果与转成 double 后再 round() 相同
+AVX2 static inline __m256 roundAwayPs(__m256 x) {
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 truncated =
+      _mm256_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m256 fraction = _mm256_andnot_ps(sign, _mm256_sub_ps(x, truncated));
+  __m256 carry = _mm256_and_ps(
+      _mm256_cmp_ps(fraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ),
+      _mm256_or_ps(_mm256_and_ps(x, sign), _mm256_set1_ps(1.0f)));
+  return _mm256_add_ps(truncated, carry);
+}
+
+// 整数乘以 float 系数后取整再加回，对应 attack += round(attack * value)
+AVX2 static inline __m256i scaleInts(const int *base, const int *offset,
+                                     const float *scale, int i) {
+  __m256i value =
+      _mm256_add_epi32(_mm256_load_si256((const __m256i *)(base + i)),
+                       _mm256_load_si256((const __m256i *)(offset + i)));
+  __m256 product = _mm256_mul_ps(_mm256_cvtepi32_ps(value),
+                                 _mm256_load_ps(scale + i));
+  return _mm256_add_epi32(value, _mm256_cvttps_epi32(roundAwayPs(product)));
+}
+
+// 一次处理 4 个车道的伤害公式，结果写入 physics 和 magic
+AVX2 static inline void calculateDamage(__m128i attack, __m128i defence,
+                                        __m128 enchant, int *physics,
+                                        int *magic) {
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d none = _mm256_set1_pd(-1.0);
+
+  __m256d attackValue = _mm256_cvtepi32_pd(attack);
+  __m256d defenceValue = _mm256_cvtepi32_pd(defence);
+  __m256d ratio = _mm256_cvtps_pd(enchant);
+  __m256d physicsAttack = _mm256_mul_pd(
+      attackValue, _mm256_sub_pd(_mm256_set1_pd(1.0), ratio));
+  __m256d magicAttack = _mm256_mul_pd(attackValue, ratio);
+
+  __m256d absorbed = _mm256_mul_pd(
+      physicsAttack, _mm256_div_pd(physicsAttack,
+                                   _mm256_add_pd(physicsAttack, defenceValue)));
+  __m256d direct = _mm256_sub_pd(physicsAttack, defenceValue);
+  __m256d damage = roundAwayPd(_mm256_blendv_pd(
+      direct, absorbed, _mm256_cmp_pd(defenceValue, zero, _CMP_GT_OQ)));
+  damage = _mm256_blendv_pd(none, damage,
+                            _mm256_cmp_pd(physicsAttack, zero, _CMP_GT_OQ));
+  _mm_store_si128((__m128i *)physics, _mm256_cvttpd_epi32(damage));
+
+  damage = _mm256_blendv_pd(none, roundAwayPd(magicAttack),
+                            _mm256_cmp_pd(magicAttack, zero, _CMP_GT_OQ));
+  _mm_store_si128((__m128i *)magic, _mm256_cvttpd_epi32(damage));
+}
+
+AVX2 static void prepareLanes(BatchSide *attacker, const BatchSide *defender,
+                              int i) {
+  __m256i attack = scaleInts(attacker->attackBase, attacker->attackOffset,
+                             attacker->strengthen, i);
+  __m256i defence = scaleInts(defender->defenceBase, defender->defenceOffset,
+                              defender->strengthen, i);
+  __m256 enchant = _mm256_load_ps(attacker->enchanting + i);
+
+  calculateDamage(_mm256_castsi256_si128(attack),
+                  _mm256_castsi256_si128(defence),
+                  _mm256_castps256_ps128(enchant), attacker->physicsDamage + i,
+                  attacker->magicDamage + i);
+  calculateDamage(_mm256_extracti128_si256(attack, 1),
+                  _mm256_extracti128_si256(defence, 1),
+                  _mm256_extractf128_ps(enchant, 1),
+                  attacker->physicsDamage + i + 4,
+                  attacker->magicDamage + i + 4);
+}
+
+// 一组车道在寄存器中的状态
+typedef struct {
+  __m256i health;
+  __m256i capacityBase;
+  __m256i capacityExtra;
+  __m256i absorbing;
+  __m256 absorbBlood;
+} LaneState;
+
+AVX2 static inline void loadLanes(LaneState *state, const BatchSide *side,
+                                  int i) {
+  state->health = _mm256_load_si256((const __m256i *)(side->health + i));
+  state->capacityBase =
+      _mm256_load_si256((const __m256i *)(side->capacityBase + i));
+  state->capacityExtra =
+      _mm256_load_si256((const __m256i *)(side->capacityExtra + i));
+  __m256i bit = _mm256_set1_epi32(EFFECT_BIT(absorbBlood));
+  state->absorbing = _mm256_cmpeq_epi32(
+      _mm256_and_si256(
+          _mm256_load_si256((const __m256i *)(side->activeEffects + i)), bit),
+      bit);
+  state->absorbBlood = _mm256_load_ps(side->absorbBlood + i);
+}
+
+// strikeLane 的向量版本，已结束或不出手的车道保持不变，返回新的结束掩码
+AVX2 static inline __m256i strikeLanes(LaneState *attacker,
+                                       LaneState *defender, __m256i damage,
+                                       int damageType, __m256i done) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i fire = _mm256_andnot_si256(
+      done, _mm256_cmpgt_epi32(damage, _mm256_set1_epi32(-1)));
+
+  __m256i health = _mm256_sub_epi32(defender->health, damage);
+  __m256i actual = _mm256_add_epi32(damage, _mm256_min_epi32(health, zero));
+  defender->health = _mm256_blendv_epi8(
+      defender->health, _mm256_max_epi32(health, zero), fire);
+  defender->capacityExtra = _mm256_blendv_epi8(
+      defender->capacityExtra,
+      _mm256_max_epi32(_mm256_sub_epi32(defender->capacityExtra, actual),
+                       zero),
+      fire);
+
+  if (damageType == 0) {
+    __m256 recovery = roundAwayPs(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(actual), attacker->absorbBlood));
+    __m256i recovered = _mm256_min_epi32(
+        _mm256_add_epi32(attacker->health, _mm256_cvttps_epi32(recovery)),
+        _mm256_add_epi32(attacker->capacityBase, attacker->capacityExtra));
+    attacker->health =
+        _mm256_blendv_epi8(attacker->health, recovered,
+                           _mm256_and_si256(fire, attacker->absorbing));
+  }
+
+  __m256i dead = _mm256_cmpgt_epi32(_mm256_set1_epi32(1), defender->health);
+  return _mm256_or_si256(done, _mm256_and_si256(fire, dead));
+}
+
+AVX2 static void runLanes(DuelBatch *batch) {
+  BatchSide *player = &batch->side[0];
+  BatchSide *enemy = &batch->side[1];
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i last = _mm256_set1_epi32(batch->count - 1);
+
+  for (int i = 0; i < batch->count; i += BATCH_WIDTH) {
+    prepareLanes(player, enemy, i);
+    prepareLanes(enemy, player, i);
+
+    LaneState p, e;
+    loadLanes(&p, player, i);
+    loadLanes(&e, enemy, i);
+    __m256i playerPhysics =
+        _mm256_load_si256((const __m256i *)(player->physicsDamage + i));
+    __m256i playerMagic =
+        _mm256_load_si256((const __m256i *)(player->magicDamage + i));
+    __m256i enemyPhysics =
+        _mm256_load_si256((const __m256i *)(enemy->physicsDamage + i));
+    __m256i enemyMagic =
+        _mm256_load_si256((const __m256i *)(enemy->magicDamage + i));
+
+    // 末尾不足一组的空车道一开始就视为结束
+    __m256i done = _mm256_cmpgt_epi32(
+        _mm256_add_epi32(lanes, _mm256_set1_epi32(i)), last);
+    for (int fightTimes = 0; fightTimes < BATTLE_ROUND_LIMIT &&
+                             _mm256_movemask_epi8(done) != -1;
+         ++fightTimes) {
+      done = strikeLanes(&p, &e, playerPhysics, 0, done);
+      done = strikeLanes(&p, &e, playerMagic, 1, done);
+      done = strikeLanes(&e, &p, enemyPhysics, 0, done);
+      done = strikeLanes(&e, &p, enemyMagic, 1, done);
+    }
+
+    _mm256_store_si256((__m256i *)(player->health + i), p.health);
+    _mm256_store_si256((__m256i *)(player->capacityExtra + i),
+                       p.capacityExtra);
+    _mm256_store_si256((__m256i *)(enemy->health + i), e.health);
+    _mm256_store_si256((__m256i *)(enemy->capacityExtra + i),
+                       e.capacityExtra);
+    __m256i enemyDead =
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(1), e.health);
+    _mm256_store_si256(
+        (__m256i *)(batch->results + i),
+        _mm256_blendv_epi8(
+            _mm256_sub_epi32(_mm256_setzero_si256(), e.health), p.health,
+            enemyDead));
+  }
+}
+#endif
+
+// 所有车道同步推进到各自分出胜负或回合耗尽
+void runBatch(DuelBatch *batch) {
+#ifdef BATCH_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    runLanes(batch);
+    return;
+  }
+#endif
+  for (int i = 0; i < batch->count; ++i) {
+    runLane(batch, i);
+  }
+}
+
+// 逐场结果与 handleBattleOut 相同，返回装入车道的对局数
+// 只含 BATCH_EFFECTS 的对局装入批次，其余对局逐场走特化内核
+int handleBattleBatch(Context *ctx, DuelBatch *batch, Energy *players,
+                      Energy *enemies, int count, int *results) {
+  if (batch->capacity <= 0 || !canUseKernel(ctx)) {
+    for (int i = 0; i < count; ++i) {
+      results[i] = handleBattleKernel(ctx, &players[i], &enemies[i]);
+    }
+    return 0;
+  }
+
+  int batched = 0;
+  int next = 0;
+  while (next < count) {
+    batch->count = 0;
+    for (; next < count && batch->count < batch->capacity; ++next) {
+      int lane = addBatchLane(batch, &players[next], &enemies[next]);
+      if (lane < 0) {
+        results[next] = handleBattleKernel(ctx, &players[next], &enemies[next]);
+      } else {
+        batch->duels[lane] = next;
+      }
+    }
+
+    runBatch(batch);
+    for (int lane = 0; lane < batch->count; ++lane) {
+      int duel = batch->duels[lane];
+      storeBatchLane(batch, lane, &players[duel], &enemies[duel]);
+      results[duel] = batch->results[lane];
+    }
+    batched += batch->count;
+  }
+  return batched;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "context.h"
+#include "energy.h"
+
+// 车道按 AVX2 的 8 个 int32 分组
+#define BATCH_WIDTH 8
+
+// 不随伤害变化的永久效果，只含这些效果的对局每次出手的伤害都相同
+#define BATCH_EFFECTS                                                          \
+  (EFFECT_BIT(strengthen) | EFFECT_BIT(enchanting) | EFFECT_BIT(absorbBlood))
+
+// 一方参战者的结构体数组，每个数组按车道排列并 32 字节对齐
+typedef struct {
+  int *health;
+  int *capacityBase;
+  int *capacityExtra;
+  int *attackBase;
+  int *attackOffset;
+  int *defenceBase;
+  int *defenceOffset;
+  int *activeEffects;
+  float *strengthen; // 未激活的效果记为 0
+  float *enchanting;
+  float *absorbBlood;
+  int *physicsDamage; // 作为攻击方每次出手的伤害，-1 表示不出手
+  int *magicDamage;
+} BatchSide;
+
+typedef struct {
+  int count;
+  int capacity;
+  BatchSide side[2]; // 0 为玩家，1 为敌人
+  int *results;      // 与 handleBattleOut 的返回值相同
+  int *duels;        // 车道对应的对局序号，由调用方填写
+  void *memory;
+} DuelBatch;
+
+extern int initBatch(DuelBatch *batch, int capacity);
+extern void freeBatch(DuelBatch *batch);
+extern int addBatchLane(DuelBatch *batch, const Energy *player,
+                        const Energy *enemy);
+extern void storeBatchLane(const DuelBatch *batch, int lane, Energy *player,
+                           Energy *enemy);
+extern void runBatch(DuelBatch *batch);
+extern int handleBattleBatch(Context *ctx, DuelBatch *batch, Energy *players,
+                             Energy *enemies, int count, int *results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCH_H
\ No newline at end of file
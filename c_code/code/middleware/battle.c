@@ -6,41 +6,48 @@
 #include "battle.h"
 #include "combat.h"
 #include "custom.h"
+#include "kernel.h"
+#include "search.h"
 
-int handleBattle(Energy *player, Energy *enemy) {
-  printAttributes(enemy);
+int handleBattle(Context *ctx, Energy *player, Energy *enemy) {
+  printAttributes(ctx, enemy);
 
   int result = 0;
-  int successively = rand() % 2;
-  customPrintf("%s got the lead\n", successively ? "Player" : "Enemy");
+  int successively = randomBelow(&ctx->random, 2);
+  LOG_PRINT(ctx, LOG_BATTLE, "%s got the lead\n",
+            successively ? "Player" : "Enemy");
 
   Action playerAction;
   Action enemyAction;
 
   while (result == 0) {
     if (successively) {
-      playerAction = getPlayerAction();
-      customPrintf("Player chose %s\n", actionToString(playerAction));
-      result = handleAction(player, enemy, playerAction);
+      playerAction = getPlayerAction(ctx);
+      LOG_PRINT(ctx, LOG_BATTLE, "Player chose %s\n",
+                actionToString(playerAction));
+      result = handleAction(ctx, player, enemy, playerAction);
       if (result) {
         break;
       }
-      enemyAction = getEnemyAction();
-      customPrintf("Enemy chose %s\n", actionToString(enemyAction));
-      result = -handleAction(enemy, player, enemyAction);
+      enemyAction = getEnemyAction(ctx);
+      LOG_PRINT(ctx, LOG_BATTLE, "Enemy chose %s\n",
+                actionToString(enemyAction));
+      result = -handleAction(ctx, enemy, player, enemyAction);
       if (result) {
         break;
       }
     } else {
-      enemyAction = getEnemyAction();
-      customPrintf("Enemy chose %s\n", actionToString(enemyAction));
-      result = -handleAction(enemy, player, enemyAction);
+      enemyAction = getEnemyAction(ctx);
+      LOG_PRINT(ctx, LOG_BATTLE, "Enemy chose %s\n",
+                actionToString(enemyAction));
+      result = -handleAction(ctx, enemy, player, enemyAction);
       if (result) {
         break;
       }
-      playerAction = getPlayerAction();
-      customPrintf("Player chose %s\n", actionToString(playerAction));
-      result = handleAction(player, enemy, playerAction);
+      playerAction = getPlayerAction(ctx);
+      LOG_PRINT(ctx, LOG_BATTLE, "Player chose %s\n",
+                actionToString(playerAction));
+      result = handleAction(ctx, player, enemy, playerAction);
       if (result) {
         break;
       }
@@ -50,15 +57,15 @@ int handleBattle(Energy *player, Energy *enemy) {
   return result;
 }
 
-int handleBattleOut(Energy *player, Energy *enemy) {
+int handleBattleOut(Context *ctx, Energy *player, Energy *enemy) {
   int fightTimes = 0;
   int result = 0;
-  while (fightTimes++ < 100) {
-    result = handleCombat(player, enemy);
+  while (fightTimes++ < BATTLE_ROUND_LIMIT) {
+    result = handleCombat(ctx, player, enemy);
     if (result) {
       break;
     }
-    result = handleCombat(enemy, player);
+    result = handleCombat(ctx, enemy, player);
     if (result) {
       break;
     }
@@ -73,7 +80,49 @@ int handleBattleOut(Energy *player, Energy *enemy) {
   return 0;
 }
 
+// 上下文挂载了搜索时敌人由 AI 出手，否则按随机分布
+Action getAutoAction(Context *ctx, const Energy *source, const Energy *target,
+                     const Energy *enemy) {
+  if (ctx->search && source == enemy) {
+    return searchEnemyAction(ctx->search, source, target);
+  }
+  return getEnemyAction(ctx);
+}
+
+// 双方都按随机行为自动对战，随机决定先手
+// 返回 1 为玩家胜利，-1 为玩家失败，0 为回合耗尽
+// ACTION_ESCAPED 为敌人逃跑，-ACTION_ESCAPED 为玩家逃跑
+int handleBattleAuto(Context *ctx, Energy *player, Energy *enemy,
+                     int *rounds) {
+  int result = 0;
+  int successively = randomBelow(&ctx->random, 2);
+  Energy *first = successively ? player : enemy;
+  Energy *second = successively ? enemy : player;
+  int sign = successively ? 1 : -1;
+
+  int fightTimes = 0;
+  while (fightTimes < BATTLE_ROUND_LIMIT) {
+    fightTimes++;
+    result = sign * handleAction(ctx, first, second,
+                                 getAutoAction(ctx, first, second, enemy));
+    if (result) {
+      break;
+    }
+    result = -sign * handleAction(ctx, second, first,
+                                  getAutoAction(ctx, second, first, enemy));
+    if (result) {
+      break;
+    }
+  }
+
+  *rounds = fightTimes;
+  return result;
+}
+
 void printAllResults() {
+  Context ctx;
+  initContext(&ctx, 0, LOG_NONE);
+
   printf("result:\n");
   printf("%-10s", " ");
   for (int i = 0; i < ENERGY_COUNT; ++i) {
@@ -86,9 +135,9 @@ void printAllResults() {
     for (int j = 0; j < ENERGY_COUNT; ++j) {
       Energy player = {.type = i};
       Energy enemy = {.type = j};
-      getPresetsAttributes(&player);
-      getPresetsAttributes(&enemy);
-      printf("%-10d", handleBattleOut(&player, &enemy));
+      getPresetsAttributes(&ctx, &player);
+      getPresetsAttributes(&ctx, &enemy);
+      printf("%-10d", handleBattleKernel(&ctx, &player, &enemy));
     }
     printf("\n");
   }
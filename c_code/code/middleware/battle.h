@@ -5,10 +5,19 @@
 extern "C" {
 #endif
 
+#include "action.h"
+#include "context.h"
 #include "energy.h"
 
-extern int handleBattle(Energy *player, Energy *enemy);
-extern int handleBattleOut(Energy *player, Energy *enemy);
+// 自动对战的回合上限
+#define BATTLE_ROUND_LIMIT 100
+
+extern int handleBattle(Context *ctx, Energy *player, Energy *enemy);
+extern int handleBattleOut(Context *ctx, Energy *player, Energy *enemy);
+extern Action getAutoAction(Context *ctx, const Energy *source,
+                            const Energy *target, const Energy *enemy);
+extern int handleBattleAuto(Context *ctx, Energy *player, Energy *enemy,
+                            int *rounds);
 extern void printAllResults();
 
 #ifdef __cplusplus
@@ -2,6 +2,22 @@
 
 #include "combat.h"
 #include "custom.h"
+#include "profile.h"
+#include "trace.h"
+
+// 各处理阶段涉及的效果，掩码为空时跳过整个阶段
+#define INSTANT_EFFECTS EFFECT_BIT(restoreLife)
+#define ATTACK_EFFECTS                                                         \
+  (EFFECT_BIT(giantKiller) | EFFECT_BIT(strengthen) | EFFECT_BIT(weakenAttack))
+#define DEFENCE_EFFECTS (EFFECT_BIT(strengthen) | EFFECT_BIT(weakenDefence))
+#define COEFF_ATTACKER_EFFECTS                                                 \
+  (EFFECT_BIT(sacrificing) | EFFECT_BIT(coeffcient))
+#define COEFF_DEFENDER_EFFECTS EFFECT_BIT(parryState)
+#define ADDITION_EFFECTS                                                       \
+  (EFFECT_BIT(physicsAddition) | EFFECT_BIT(magicAddition))
+#define DEDUCT_EFFECTS                                                         \
+  (EFFECT_BIT(adjustAttribute) | EFFECT_BIT(exemptionDeath))
+#define COUNTER_EFFECTS (EFFECT_BIT(rugged) | EFFECT_BIT(revengeAtonce))
 
 // 改变生命值
 int addHealth(Energy *energy, int value) {
@@ -23,23 +39,25 @@ int reduceHealth(Energy *energy, int value) {
   return value;
 }
 
-int handleRecoverHealth(Energy *energy, int recovery);
-int handleDeductHealth(Energy *energy, int damage, int damageType);
+int handleRecoverHealth(Context *ctx, Energy *energy, int recovery);
+int handleDeductHealth(Context *ctx, Energy *energy, int damage,
+                       int damageType);
 
 // 处理即时效果
-int handleInstantlyEffect(Energy *attacker, Energy *defender) {
+int handleInstantlyEffect(Context *ctx, Energy *attacker, Energy *defender) {
   int result = 0;
 
   CombatEffect *effect = &defender->effects[restoreLife];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(defender, restoreLife)) {
     int recovery = round(
         (effect->value * (attacker->capacityBase + attacker->capacityExtra)));
 
-    handleRecoverHealth(defender, recovery);
-    customPrintf("%s 回复了 %d 生命值❤️‍🩹, "
-                 "当前生命值为 "
-                 "%d\n",
-                 defender->name, recovery, defender->health);
+    handleRecoverHealth(ctx, defender, recovery);
+    LOG_PRINT(ctx, LOG_DETAIL,
+              "%s 回复了 %d 生命值❤️‍🩹, "
+              "当前生命值为 "
+              "%d\n",
+              defender->name, recovery, defender->health);
     result = 1;
   }
 
@@ -47,39 +65,46 @@ int handleInstantlyEffect(Energy *attacker, Energy *defender) {
 }
 
 // 处理攻击效果
-int handleAttackEffect(Energy *attacker, Energy *defender, int expend) {
+int handleAttackEffect(Context *ctx, Energy *attacker, Energy *defender,
+                       int expend) {
   int attack = attacker->attackBase + attacker->attackOffset;
   CombatEffect *effect;
 
   effect = &attacker->effects[giantKiller];
-  if (expend ? expendEffect(effect) : checkEffect(effect)) {
+  if (expend ? expendEnergyEffect(attacker, giantKiller)
+             : EFFECT_ACTIVE(attacker, giantKiller)) {
     attack += round(defender->health * effect->value);
   }
 
   effect = &attacker->effects[strengthen];
-  if (expend ? expendEffect(effect) : checkEffect(effect)) {
+  if (expend ? expendEnergyEffect(attacker, strengthen)
+             : EFFECT_ACTIVE(attacker, strengthen)) {
     attack += round(attack * effect->value);
   }
 
   effect = &attacker->effects[weakenAttack];
-  if (expend ? expendEffect(effect) : checkEffect(effect)) {
+  if (expend ? expendEnergyEffect(attacker, weakenAttack)
+             : EFFECT_ACTIVE(attacker, weakenAttack)) {
     attack -= round(attack * effect->value);
   }
   return attack;
 }
 
 // 处理防御效果
-int handleDefenceEffect(Energy *attacker, Energy *defender, int expend) {
+int handleDefenceEffect(Context *ctx, Energy *attacker, Energy *defender,
+                        int expend) {
   int defence = defender->defenceBase + defender->defenceOffset;
   CombatEffect *effect;
 
   effect = &defender->effects[strengthen];
-  if (expend ? expendEffect(effect) : checkEffect(effect)) {
+  if (expend ? expendEnergyEffect(defender, strengthen)
+             : EFFECT_ACTIVE(defender, strengthen)) {
     defence += round(defence * effect->value);
   }
 
   effect = &defender->effects[weakenDefence];
-  if (expend ? expendEffect(effect) : checkEffect(effect)) {
+  if (expend ? expendEnergyEffect(defender, weakenDefence)
+             : EFFECT_ACTIVE(defender, weakenDefence)) {
     defence -= round(defence * effect->value);
   }
 
@@ -87,49 +112,52 @@ int handleDefenceEffect(Energy *attacker, Energy *defender, int expend) {
 }
 
 // 处理系数效果
-double handleCoeffcientEffect(Energy *attacker, Energy *defender) {
+double handleCoeffcientEffect(Context *ctx, Energy *attacker,
+                              Energy *defender) {
   double coeff = 1.0;
 
   CombatEffect *effect;
 
   effect = &attacker->effects[sacrificing];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(attacker, sacrificing)) {
     int deduction = round(attacker->health - effect->value);
     double increaseCoeff = deduction / (double)attacker->capacityBase;
 
     coeff *= (1 + increaseCoeff);
 
-    handleDeductHealth(attacker, deduction, 0); // 假设 0 为法术伤害类型
+    handleDeductHealth(ctx, attacker, deduction, 0); // 假设 0 为法术伤害类型
+    TRACE_EVENT(ctx, TRACE_SACRIFICE, attacker, 0, deduction, attacker->health);
 
-    customPrintf("%s 对自身造成 %d ⚡法术伤害，伤害系数提高 %.0f%% "
-                 "， 当前生命值为 %d\n",
-                 attacker->name, deduction, (increaseCoeff * 100),
-                 attacker->health);
+    LOG_PRINT(ctx, LOG_DETAIL,
+              "%s 对自身造成 %d ⚡法术伤害，伤害系数提高 %.0f%% "
+              "， 当前生命值为 %d\n",
+              attacker->name, deduction, (increaseCoeff * 100),
+              attacker->health);
   }
 
   effect = &attacker->effects[coeffcient];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(attacker, coeffcient)) {
     coeff *= (1 + effect->value);
-    if (!checkEffect(effect)) {
+    if (!EFFECT_ACTIVE(attacker, coeffcient)) {
       effect->value = 0;
     }
   }
 
   effect = &defender->effects[parryState];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(defender, parryState)) {
     coeff *= (1 - effect->value);
   }
 
   return coeff;
 }
 
-double handleEnchantRatio(Energy *attacker, Energy *defender) {
+double handleEnchantRatio(Context *ctx, Energy *attacker, Energy *defender) {
   CombatEffect *effect;
 
   double enchantRatio = 0.0;
 
   effect = &attacker->effects[enchanting];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(attacker, enchanting)) {
     if (effect->value > 1) {
       effect->value = 1;
     } else if (effect->value < 0) {
@@ -137,7 +165,7 @@ double handleEnchantRatio(Energy *attacker, Energy *defender) {
     }
     enchantRatio = effect->value;
 
-    if (!checkEffect(effect)) {
+    if (!EFFECT_ACTIVE(attacker, enchanting)) {
       effect->value = 0;
     }
   }
@@ -146,7 +174,8 @@ double handleEnchantRatio(Energy *attacker, Energy *defender) {
 }
 
 // 计算伤害
-int handleCalculateDamage(double attack, int defence, double coeff) {
+int handleCalculateDamage(Context *ctx, double attack, int defence,
+                          double coeff) {
   int damage = 0;
 
   if (defence > 0) {
@@ -155,105 +184,117 @@ int handleCalculateDamage(double attack, int defence, double coeff) {
     damage = round((attack - defence) * coeff);
   }
 
-  customPrintf("⚔️:%.1f 🛡️:%d %0.0f%% => 💔:%d\n", attack, defence, coeff * 100,
-               damage);
+  LOG_PRINT(ctx, LOG_DETAIL, "⚔️:%.1f 🛡️:%d %0.0f%% => 💔:%d\n", attack, defence,
+            coeff * 100, damage);
 
   return damage;
 }
 
 // 处理增加容量效果
-void handleIncreaseCapacity(Energy *energy, int recovery) {
+void handleIncreaseCapacity(Context *ctx, Energy *energy, int recovery) {
   int checkHealth = energy->health + recovery;
   int capacity = energy->capacityBase + energy->capacityExtra;
 
   if (checkHealth > capacity) {
-    CombatEffect *effect = &energy->effects[increaseCapacity];
-    if (expendEffect(effect)) {
+    if (expendEnergyEffect(energy, increaseCapacity)) {
       energy->capacityExtra += checkHealth - capacity;
     }
   }
 }
 
 // 根据恢复生命值调整属性
-void handleAdjustByRecovery(Energy *energy, int recovery) {
+void handleAdjustByRecovery(Context *ctx, Energy *energy, int recovery) {
   CombatEffect *effect = &energy->effects[adjustAttribute];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(energy, adjustAttribute)) {
     double recoveryRatio = recovery / (double)energy->capacityBase;
     double healthRatio = energy->health / (double)energy->capacityBase;
 
-    int adjustValue = round(
-        (energy->defenceBase * recoveryRatio * pow(healthRatio + 0.3, 6.2)));
+    int adjustValue = curveAdjustValue(
+        &ctx->curve, energy->defenceBase * recoveryRatio, healthRatio);
 
     energy->defenceOffset += adjustValue;
-    energy->attackOffset -= round(adjustValue * effect->value);
+    energy->attackOffset -= roundToInt(adjustValue * effect->value);
   }
 }
 
 // 回复生命值
-int handleRecoverHealth(Energy *energy, int recovery) {
+int handleRecoverHealth(Context *ctx, Energy *energy, int recovery) {
 
-  handleIncreaseCapacity(energy, recovery);
+  if (EFFECT_ACTIVE(energy, increaseCapacity)) {
+    handleIncreaseCapacity(ctx, energy, recovery);
+  }
 
   int ActualRecovery = addHealth(energy, recovery);
 
-  handleAdjustByRecovery(energy, ActualRecovery);
+  if (EFFECT_ACTIVE(energy, adjustAttribute)) {
+    handleAdjustByRecovery(ctx, energy, ActualRecovery);
+  }
+
+  TRACE_EVENT(ctx, TRACE_RECOVER, energy, 0, ActualRecovery, energy->health);
 
   return ActualRecovery;
 }
 
 // 处理伤害转化为生命值效果
-void handleDamageToBlood(Energy *energy, int damage) {
+void handleDamageToBlood(Context *ctx, Energy *energy, int damage) {
   CombatEffect *effect = &energy->effects[absorbBlood];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(energy, absorbBlood)) {
     int recovery = round(damage * effect->value);
-    int actualRecovery = handleRecoverHealth(energy, recovery);
-    customPrintf("%s 回复了 %d 生命值❤️‍🩹, "
-                 "当前生命值为 "
-                 "%d\n",
-                 energy->name, actualRecovery, energy->health);
+    int actualRecovery = handleRecoverHealth(ctx, energy, recovery);
+    LOG_PRINT(ctx, LOG_DETAIL,
+              "%s 回复了 %d 生命值❤️‍🩹, "
+              "当前生命值为 "
+              "%d\n",
+              energy->name, actualRecovery, energy->health);
   }
 }
 
 // 处理热伤害效果
-void handleHotDamage(Energy *attacker, Energy *defender, int damage,
-                     int damageType) {
+void handleHotDamage(Context *ctx, Energy *attacker, Energy *defender,
+                     int damage, int damageType) {
   if (damageType) {
     CombatEffect *effect = &attacker->effects[hotDamage];
-    if (expendEffect(effect)) {
+    if (expendEnergyEffect(attacker, hotDamage)) {
       defender->effects[burnDamage].value += round(damage * effect->value);
-      defender->effects[burnDamage].times = 1;
+      setEffectTimes(defender, burnDamage, 1);
     }
   }
 }
 
-int handleAttack(Energy *attacker, Energy *defender, double attack, int defence,
-                 double coeff, int damageType);
+int handleAttack(Context *ctx, Energy *attacker, Energy *defender,
+                 double attack, int defence, double coeff, int damageType);
 
 // 处理反击伤害效果
-int handleDamageToCounter(Energy *attacker, Energy *defender) {
+int handleDamageToCounter(Context *ctx, Energy *attacker, Energy *defender) {
   int result = 0;
 
   CombatEffect *effect = &defender->effects[rugged];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(defender, rugged)) {
+    TRACE_EVENT(ctx, TRACE_COUNTER, defender, 0, 1, defender->health);
+
     double attack = ((defender->capacityBase + defender->capacityExtra) -
                      defender->health) *
                     effect->value;
 
-    int defence = handleDefenceEffect(defender, attacker, 1);
+    int defence;
+    PROFILE_CALL(ctx, PROFILE_DEFENCE_EFFECT, defence,
+                 handleDefenceEffect(ctx, defender, attacker, 1));
 
-    result =
-        -handleAttack(defender, attacker, attack, defence, effect->value, 0);
+    result = -handleAttack(ctx, defender, attacker, attack, defence,
+                           effect->value, 0);
     if (result != 0) {
       return result;
     }
   }
 
   effect = &defender->effects[revengeAtonce];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(defender, revengeAtonce)) {
     int counterCount = round(effect->value);
+    TRACE_EVENT(ctx, TRACE_COUNTER, defender, 1, counterCount,
+                defender->health);
 
     for (int i = 0; i < counterCount; ++i) {
-      result = -handleCombat(defender, attacker);
+      result = -handleCombat(ctx, defender, attacker);
       if (result != 0) {
         return result;
       }
@@ -262,184 +303,211 @@ int handleDamageToCounter(Energy *attacker, Energy *defender) {
   return 0;
 }
 
+// 反击在造成伤害的当下直接递归结算，顺序为深度优先：反击造成的伤害再触发的反击，
+// 先于本次反击的后续伤害结算，坚韧反伤引起的整条反击链结算完才轮到立即反击。
+// 这里只限制递归层数，链长超过 chainLimit 的反击被丢弃并计入 dropped
+static int handleCounter(Context *ctx, Energy *attacker, Energy *defender) {
+  if (!enterReaction(&ctx->reactions)) {
+    return 0;
+  }
+  int result = handleDamageToCounter(ctx, attacker, defender);
+  leaveReaction(&ctx->reactions);
+  return result;
+}
+
 // 根据伤害调整属性
-void handleAdjustByDamage(Energy *energy, int damage, int damageType) {
+void handleAdjustByDamage(Context *ctx, Energy *energy, int damage,
+                          int damageType) {
 
   CombatEffect *effect = &energy->effects[adjustAttribute];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(energy, adjustAttribute)) {
     int health = energy->health + damage; // 计算受到伤害前的生命值
 
     double damageRatio = damage / (double)energy->capacityBase;
     double healthRatio = health / (double)energy->capacityBase;
 
-    // 方案0
-    // int adjustValue = round(energy->defenceBase * damageRatio *
-    //                         pow(healthRatio + sqrt(2) - 1, 4));
-    // energy->effects[absorbBlood].value = 0.4;
-
-    // 方案1
-    // int adjustValue = round(energy->defenceBase * damageRatio *
-    //                         pow(healthRatio + sqrt(2) - 1, 1.75));
-    // energy->effects[absorbBlood].value = 0.32;
-
-    // 方案2
-    // damage = round(attack * (attack / (attack + (defence * 2))) * coeff);
-    // int adjustValue =
-    // round(energy->defenceBase * damageRatio * pow(healthRatio + 0.28, 3));
-    // energy->effects[adjustAttribute].value = 1;
-    // energy->defenceBase = 24;
-    // energy->effects[absorbBlood].value = 0.8;
-    // energy->effects[accumulateAnger].value = 0.75;
-
-    // 方案3
-    // energy->effects[adjustAttribute].value = 0.75;
-    // energy->effects[absorbBlood].value = 0.125;
-    // int adjustValue = round(energy->defenceBase * damageRatio *
-    //                         pow(healthRatio + sqrt(2) - 1, 3.05));
-
-    int adjustValue =
-        round(energy->defenceBase * damageRatio * pow(healthRatio + 0.3, 6.2));
+    // 方案0-3 的曲线及配套预设见 curve.c
+    int adjustValue = curveAdjustValue(
+        &ctx->curve, energy->defenceBase * damageRatio, healthRatio);
 
     energy->defenceOffset -= adjustValue;
-    energy->attackOffset += round(adjustValue * effect->value);
+    energy->attackOffset += roundToInt(adjustValue * effect->value);
 
     if (damageType) {
       effect = &energy->effects[enchanting];
       effect->value += damageRatio;
-      effect->times += 1;
+      setEffectTimes(energy, enchanting, effect->times + 1);
     }
   }
 }
 
 // 处理免疫死亡效果
-void handleExemptionDeath(Energy *energy) {
+void handleExemptionDeath(Context *ctx, Energy *energy) {
   if (energy->health <= 0) {
     CombatEffect *effect = &energy->effects[exemptionDeath];
-    if (expendEffect(effect)) {
-      handleRecoverHealth(energy, round(effect->value - energy->health));
+    if (expendEnergyEffect(energy, exemptionDeath)) {
+      handleRecoverHealth(ctx, energy, round(effect->value - energy->health));
+      TRACE_EVENT(ctx, TRACE_EXEMPTION, energy, 0, round(effect->value),
+                  energy->health);
     }
   }
 }
 
 // 处理伤害附加效果
-void handleDamageToAddition(Energy *energy, int damage, int damageType) {
+void handleDamageToAddition(Context *ctx, Energy *energy, int damage,
+                            int damageType) {
   CombatEffect *effect = &energy->effects[accumulateAnger];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(energy, accumulateAnger)) {
     if (damageType) {
       int addition = round(damage * effect->value * 0.3);
       effect = &energy->effects[magicAddition];
       effect->value += addition;
-      effect->times = 1;
+      setEffectTimes(energy, magicAddition, 1);
     } else {
       int addition = round(damage * effect->value);
       effect = &energy->effects[physicsAddition];
       effect->value += addition;
-      effect->times = 1;
+      setEffectTimes(energy, physicsAddition, 1);
     }
   }
 }
 
 // 扣除生命值
-int handleDeductHealth(Energy *energy, int damage, int damageType) {
+int handleDeductHealth(Context *ctx, Energy *energy, int damage,
+                       int damageType) {
 
   damage = reduceHealth(energy, damage);
-  handleAdjustByDamage(energy, damage, damageType);
+  if (energy->activeEffects & DEDUCT_EFFECTS) {
+    handleAdjustByDamage(ctx, energy, damage, damageType);
 
-  handleExemptionDeath(energy);
+    handleExemptionDeath(ctx, energy);
+  }
 
   energy->capacityExtra -= damage;
   if (energy->capacityExtra < 0) {
     energy->capacityExtra = 0;
   }
 
-  handleDamageToAddition(energy, damage, damageType);
+  if (EFFECT_ACTIVE(energy, accumulateAnger)) {
+    handleDamageToAddition(ctx, energy, damage, damageType);
+  }
 
   return damage;
 }
 
 // 处理伤害
-int handleDamage(Energy *attacker, Energy *defender, int damage,
+int handleDamage(Context *ctx, Energy *attacker, Energy *defender, int damage,
                  int damageType) {
 
-  int ActualDamage = handleDeductHealth(defender, damage, damageType);
+  int ActualDamage = handleDeductHealth(ctx, defender, damage, damageType);
+  TRACE_EVENT(ctx, TRACE_DAMAGE, defender, damageType, ActualDamage,
+              defender->health);
 
-  customPrintf("%s 受到 %d %s 伤害, "
-               "当前生命值为 %d\n",
-               defender->name, ActualDamage, damageType ? "⚡法术" : "🗡️物理",
-               defender->health);
+  LOG_PRINT(ctx, LOG_DETAIL,
+            "%s 受到 %d %s 伤害, "
+            "当前生命值为 %d\n",
+            defender->name, ActualDamage, damageType ? "⚡法术" : "🗡️物理",
+            defender->health);
 
-  if (damageType == 0) {
-    handleDamageToBlood(attacker, ActualDamage);
+  if (damageType == 0 && EFFECT_ACTIVE(attacker, absorbBlood)) {
+    handleDamageToBlood(ctx, attacker, ActualDamage);
   }
 
   if (defender->health <= 0) {
     return 1;
   } else {
-    handleHotDamage(attacker, defender, damage, damageType);
-    return handleDamageToCounter(attacker, defender);
+    if (EFFECT_ACTIVE(attacker, hotDamage)) {
+      handleHotDamage(ctx, attacker, defender, damage, damageType);
+    }
+    return (defender->activeEffects & COUNTER_EFFECTS)
+               ? handleCounter(ctx, attacker, defender)
+               : 0;
   }
 }
 
 // 处理攻击
-int handleAttack(Energy *attacker, Energy *defender, double attack, int defence,
-                 double coeff, int damageType) {
+int handleAttack(Context *ctx, Energy *attacker, Energy *defender,
+                 double attack, int defence, double coeff, int damageType) {
   if (attack > 0) {
-    int damage = handleCalculateDamage(attack, defence, coeff);
+    int damage = handleCalculateDamage(ctx, attack, defence, coeff);
 
-    return handleDamage(attacker, defender, damage, damageType);
+    int result;
+    PROFILE_CALL(ctx, PROFILE_DAMAGE, result,
+                 handleDamage(ctx, attacker, defender, damage, damageType));
+    return result;
   } else {
     return 0;
   }
 }
 
 // 处理战斗
-int handleCombat(Energy *attacker, Energy *defender) {
+int handleCombat(Context *ctx, Energy *attacker, Energy *defender) {
   int result = 0;
   int combatCount = 1;
 
-  result = handleInstantlyEffect(attacker, defender);
-  if (result != 0) {
-    return 0;
+  if (defender->activeEffects & INSTANT_EFFECTS) {
+    result = handleInstantlyEffect(ctx, attacker, defender);
+    if (result != 0) {
+      return 0;
+    }
   }
 
   CombatEffect *effect;
 
   effect = &attacker->effects[multipleHit];
-  if (expendEffect(effect)) {
+  if (expendEnergyEffect(attacker, multipleHit)) {
     combatCount += round(effect->value);
   }
 
   for (int i = 0; i < combatCount; ++i) {
 
-    int attack = handleAttackEffect(attacker, defender, 1);
+    int attack = attacker->attackBase + attacker->attackOffset;
+    if (attacker->activeEffects & ATTACK_EFFECTS) {
+      PROFILE_CALL(ctx, PROFILE_ATTACK_EFFECT, attack,
+                   handleAttackEffect(ctx, attacker, defender, 1));
+    }
 
-    int defence = handleDefenceEffect(attacker, defender, 1);
+    int defence = defender->defenceBase + defender->defenceOffset;
+    if (defender->activeEffects & DEFENCE_EFFECTS) {
+      PROFILE_CALL(ctx, PROFILE_DEFENCE_EFFECT, defence,
+                   handleDefenceEffect(ctx, attacker, defender, 1));
+    }
 
-    double coeff = handleCoeffcientEffect(attacker, defender);
+    double coeff = 1.0;
+    if ((attacker->activeEffects & COEFF_ATTACKER_EFFECTS) ||
+        (defender->activeEffects & COEFF_DEFENDER_EFFECTS)) {
+      PROFILE_CALL(ctx, PROFILE_COEFF_EFFECT, coeff,
+                   handleCoeffcientEffect(ctx, attacker, defender));
+    }
 
-    double enchantRatio = handleEnchantRatio(attacker, defender);
+    double enchantRatio = EFFECT_ACTIVE(attacker, enchanting)
+                              ? handleEnchantRatio(ctx, attacker, defender)
+                              : 0.0;
 
     double physicsAttack = attack * (1 - enchantRatio);
     double magicAttack = attack * enchantRatio;
 
-    effect = &attacker->effects[physicsAddition];
-    if (expendEffect(effect)) {
-      physicsAttack += effect->value;
-      effect->value = 0;
-    }
+    if (attacker->activeEffects & ADDITION_EFFECTS) {
+      effect = &attacker->effects[physicsAddition];
+      if (expendEnergyEffect(attacker, physicsAddition)) {
+        physicsAttack += effect->value;
+        effect->value = 0;
+      }
 
-    effect = &attacker->effects[magicAddition];
-    if (expendEffect(effect)) {
-      magicAttack += effect->value;
-      effect->value = 0;
+      effect = &attacker->effects[magicAddition];
+      if (expendEnergyEffect(attacker, magicAddition)) {
+        magicAttack += effect->value;
+        effect->value = 0;
+      }
     }
 
-    result = handleAttack(attacker, defender, physicsAttack, defence, coeff, 0);
+    result = handleAttack(ctx, attacker, defender, physicsAttack, defence,
+                          coeff, 0);
     if (result != 0) {
       return result;
     }
 
-    result = handleAttack(attacker, defender, magicAttack, 0, coeff, 1);
+    result = handleAttack(ctx, attacker, defender, magicAttack, 0, coeff, 1);
     if (result != 0) {
       return result;
     }
@@ -5,9 +5,10 @@
 extern "C" {
 #endif
 
+#include "context.h"
 #include "energy.h"
 
-extern int handleCombat(Energy *attacker, Energy *defender);
+extern int handleCombat(Context *ctx, Energy *attacker, Energy *defender);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,172 @@
+#include <stddef.h>
+
+#include "action.h"
+#include "attribute.h"
+#include "battle.h"
+#include "elemental.h"
+
+// EnergyType 的顺序恰好是相生顺序
+const EnergyType generationOrder[ENERGY_COUNT] = {WATER, WOOD, FIRE, EARTH,
+                                                  METAL};
+
+const EnergyType flutterOrder[ENERGY_COUNT] = {METAL, WOOD, WATER, FIRE, EARTH};
+
+// flutterOrder 的逆映射，EnergyType 在 Flutter 端的下标
+static const int flutterIndex[ENERGY_COUNT] = {
+    [METAL] = 0, [WOOD] = 1, [WATER] = 2, [FIRE] = 3, [EARTH] = 4};
+
+// 与 Flutter 端 getDefaultConfig 一致，aptitudes 为启用灵根的位掩码
+void initEnergyConfigs(EnergyConfig configs[ENERGY_COUNT],
+                       unsigned int aptitudes, int skillPoints) {
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    configs[i].aptitude = (aptitudes >> i) & 1;
+    configs[i].healthPoints = 0;
+    configs[i].attackPoints = 0;
+    configs[i].defencePoints = 0;
+    configs[i].skillPoints = skillPoints;
+  }
+}
+
+// 与 Flutter 端 Elemental 构造一致：按配置加点、学习技能，随机选择初始灵根
+void initElemental(Context *ctx, Elemental *elemental, const char *name,
+                   const EnergyConfig configs[ENERGY_COUNT]) {
+  elemental->aptitudes = 0;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    Energy *energy = &elemental->energies[i];
+    energy->type = i;
+    energy->level = 0;
+    energy->name = name;
+    getPresetsAttributes(ctx, energy);
+    int points[ATTRIBUTE_COUNT] = {configs[i].healthPoints,
+                                   configs[i].attackPoints,
+                                   configs[i].defencePoints};
+    upgradeBulk(ctx, energy, points);
+    // 预设被动只在学习后生效，统一由 applyElementalPassives 施加
+    restoreEffects(energy);
+
+    initSkillBook(&elemental->books[i], i);
+    for (int slot = 0; slot < configs[i].skillPoints; ++slot) {
+      if (learnSkill(&elemental->books[i], slot)) {
+        energy->level++;
+      }
+    }
+    if (configs[i].aptitude) {
+      elemental->aptitudes |= 1u << i;
+    }
+  }
+
+  elemental->current = flutterOrder[randomBelow(&ctx->random, ENERGY_COUNT)];
+  switchPrevious(elemental);
+}
+
+// 战斗开始前施加所有已学习的被动技能
+void applyElementalPassives(Elemental *elemental) {
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    applyPassiveSkills(&elemental->books[i], &elemental->energies[i]);
+  }
+}
+
+int isEnergyAlive(const Elemental *elemental, int index) {
+  return ((elemental->aptitudes >> index) & 1) &&
+         elemental->energies[index].health > 0;
+}
+
+int countAliveEnergies(const Elemental *elemental) {
+  int count = 0;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    count += isEnergyAlive(elemental, i);
+  }
+  return count;
+}
+
+// 从 start 起按 Flutter 端的灵根顺序走 step 步查找下一个存活的灵根，
+// 最后才回到 start，找不到时不变
+int findNextIndex(const Elemental *elemental, int start, int step) {
+  for (int i = 1; i <= ENERGY_COUNT; ++i) {
+    int position = ((flutterIndex[start] + step * i) % ENERGY_COUNT +
+                    ENERGY_COUNT) %
+                   ENERGY_COUNT;
+    int index = flutterOrder[position];
+    if (isEnergyAlive(elemental, index)) {
+      return index;
+    }
+  }
+  return elemental->current;
+}
+
+void switchPrevious(Elemental *elemental) {
+  elemental->current = findNextIndex(elemental, elemental->current, -1);
+}
+
+void switchNext(Elemental *elemental) {
+  elemental->current = findNextIndex(elemental, elemental->current, 1);
+}
+
+// 按相生顺序切换到下一个存活的灵根，返回是否切换成功
+int switchByOrder(Elemental *elemental) {
+  EnergyType type = elemental->current;
+  for (int i = 1; i < ENERGY_COUNT; ++i) {
+    type = generationOrder[type];
+    if (isEnergyAlive(elemental, type)) {
+      elemental->current = type;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// 未学习主动0的灵根只会攻击，与 Flutter 端敌人的行为一致
+static Action getTeamAction(Context *ctx, const Elemental *source,
+                            const Elemental *target, const Elemental *enemy) {
+  const Energy *front = &source->energies[source->current];
+  if (!(source->books[source->current].learned & (1u << SKILL_SLOT_ACTIVE))) {
+    return ATTACK;
+  }
+  return getAutoAction(ctx, front, &target->energies[target->current],
+                       source == enemy ? front : NULL);
+}
+
+// 一次出手，当前灵根阵亡时按相生顺序换上下一个，全部阵亡才分出胜负
+// 返回值以 source 为视角
+static int handleTeamAction(Context *ctx, Elemental *source,
+                            Elemental *target, Action action) {
+  int result = handleAction(ctx, &source->energies[source->current],
+                            &target->energies[target->current], action);
+  if (result == 1 && switchByOrder(target)) {
+    result = 0;
+  } else if (result == -1 && switchByOrder(source)) {
+    result = 0;
+  }
+  return result;
+}
+
+// 与 handleBattleAuto 相同的规则，返回值含义也相同
+int handleBattleTeam(Context *ctx, Elemental *player, Elemental *enemy,
+                     int *rounds) {
+  applyElementalPassives(player);
+  applyElementalPassives(enemy);
+
+  int result = 0;
+  int successively = randomBelow(&ctx->random, 2);
+  Elemental *first = successively ? player : enemy;
+  Elemental *second = successively ? enemy : player;
+  int sign = successively ? 1 : -1;
+
+  int fightTimes = 0;
+  while (fightTimes < TEAM_ROUND_LIMIT) {
+    fightTimes++;
+    result = sign * handleTeamAction(ctx, first, second,
+                                     getTeamAction(ctx, first, second, enemy));
+    if (result) {
+      break;
+    }
+    result = -sign * handleTeamAction(ctx, second, first,
+                                      getTeamAction(ctx, second, first, enemy));
+    if (result) {
+      break;
+    }
+  }
+
+  *rounds = fightTimes;
+  return result;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef ELEMENTAL_H
+#define ELEMENTAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "battle.h"
+#include "context.h"
+#include "energy.h"
+#include "skill.h"
+
+// 队伍对战的回合上限，每个灵根各有一次单挑的回合数
+#define TEAM_ROUND_LIMIT (BATTLE_ROUND_LIMIT * ENERGY_COUNT)
+
+// 与 Flutter 端 EnergyConfig 一致
+typedef struct {
+  int aptitude; // 是否拥有该灵根
+  int healthPoints;
+  int attackPoints;
+  int defencePoints;
+  int skillPoints; // 按槽位顺序学习的技能数
+} EnergyConfig;
+
+// 多灵根的一方，灵根按 EnergyType 索引，current 为当前上场的灵根
+typedef struct {
+  Energy energies[ENERGY_COUNT];
+  SkillBook books[ENERGY_COUNT];
+  unsigned int aptitudes; // 按 EnergyType 的位掩码
+  int current;
+} Elemental;
+
+// 五行相生的下一个灵根，金生水、水生木、木生火、火生土、土生金
+extern const EnergyType generationOrder[ENERGY_COUNT];
+// Flutter 端 EnergyType.values 的顺序，金木水火土，与本端的枚举顺序不同
+// switchPrevious、switchNext 按它逐个切换
+extern const EnergyType flutterOrder[ENERGY_COUNT];
+
+extern void initEnergyConfigs(EnergyConfig configs[ENERGY_COUNT],
+                              unsigned int aptitudes, int skillPoints);
+extern void initElemental(Context *ctx, Elemental *elemental, const char *name,
+                          const EnergyConfig configs[ENERGY_COUNT]);
+extern void applyElementalPassives(Elemental *elemental);
+extern int isEnergyAlive(const Elemental *elemental, int index);
+extern int countAliveEnergies(const Elemental *elemental);
+extern int findNextIndex(const Elemental *elemental, int start, int step);
+extern void switchPrevious(Elemental *elemental);
+extern void switchNext(Elemental *elemental);
+extern int switchByOrder(Elemental *elemental);
+extern int handleBattleTeam(Context *ctx, Elemental *player, Elemental *enemy,
+                            int *rounds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ELEMENTAL_H
\ No newline at end of file
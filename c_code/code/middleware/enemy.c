@@ -0,0 +1,92 @@
+#include <stdlib.h>
+
+#include "attribute.h"
+#include "enemy.h"
+
+// 敌人只由 (属性, 等级, 种子) 决定，与调用方的随机序列无关
+void buildEnemy(Energy *enemy, const PresetTable *presets, EnergyType type,
+                int level, uint64_t seed) {
+  Context ctx;
+  initContext(&ctx, seed, LOG_NONE);
+  ctx.presets = presets;
+  enemy->name = "enemy";
+  enemy->type = type;
+  enemy->level = 0;
+  getPresetsAttributes(&ctx, enemy);
+  upgradeRandom(&ctx, enemy, level);
+}
+
+// 由基础种子和变体编号混合出敌人的种子，相邻的基础种子不会共用变体
+uint64_t enemyVariantSeed(uint64_t seed, uint64_t variant) {
+  Random random;
+  seedRandomStream(&random, seed, ENEMY_VARIANT_STREAM | variant);
+  return nextRandom64(&random);
+}
+
+// capacity 向下取整到组数为 2 的幂，返回是否成功
+int initEnemyCache(EnemyCache *cache, int capacity) {
+  uint32_t sets = 1;
+  while (sets * 2 * ENEMY_CACHE_WAYS <= (uint32_t)capacity) {
+    sets *= 2;
+  }
+  cache->templates = malloc(sizeof(EnemyTemplate) * sets * ENEMY_CACHE_WAYS);
+  if (cache->templates == NULL) {
+    return 0;
+  }
+  for (uint32_t i = 0; i < sets * ENEMY_CACHE_WAYS; ++i) {
+    cache->templates[i].type = -1;
+    cache->templates[i].used = 0;
+  }
+  cache->mask = sets - 1;
+  cache->clock = 0;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+  cache->presets = NULL;
+  return 1;
+}
+
+void freeEnemyCache(EnemyCache *cache) {
+  free(cache->templates);
+  cache->templates = NULL;
+}
+
+static uint32_t hashTemplate(EnergyType type, int level, uint64_t seed) {
+  uint64_t x = seed ^ ((uint64_t)level << 8) ^ (uint64_t)type;
+  x = (x ^ (x >> 33)) * 0xFF51AFD7ED558CCDULL;
+  x = (x ^ (x >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  return (uint32_t)(x ^ (x >> 33));
+}
+
+// 命中时只复制一次结构体，未命中时构建并替换组内最久未使用的模板
+void spawnEnemy(EnemyCache *cache, Energy *enemy, EnergyType type, int level,
+                uint64_t seed) {
+  EnemyTemplate *set =
+      &cache->templates[(hashTemplate(type, level, seed) & cache->mask) *
+                        ENEMY_CACHE_WAYS];
+  EnemyTemplate *victim = &set[0];
+  for (int i = 0; i < ENEMY_CACHE_WAYS; ++i) {
+    EnemyTemplate *item = &set[i];
+    if (item->type == (int16_t)type && item->level == level &&
+        item->seed == seed) {
+      item->used = ++cache->clock;
+      cache->hits++;
+      *enemy = item->energy;
+      return;
+    }
+    if (item->used < victim->used) {
+      victim = item;
+    }
+  }
+
+  cache->misses++;
+  if (victim->type >= 0) {
+    cache->evictions++;
+  }
+  buildEnemy(&victim->energy, cache->presets, type, level, seed);
+  victim->type = type;
+  victim->level = level;
+  victim->seed = seed;
+  victim->used = ++cache->clock;
+  *enemy = victim->energy;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef ENEMY_H
+#define ENEMY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "context.h"
+#include "energy.h"
+
+// 每个组的模板数，组满时淘汰最久未使用的模板
+#define ENEMY_CACHE_WAYS 4
+// 交互模式下每个 (属性, 等级) 的敌人变体数
+#define ENEMY_VARIANTS 16
+// 变体使用的随机流编号最高位，与对局的流编号不会重叠
+#define ENEMY_VARIANT_STREAM (1ull << 63)
+
+typedef struct {
+  Energy energy;
+  uint64_t seed;
+  int32_t level;
+  int16_t type; // -1 表示空模板
+  uint16_t reserved;
+  uint64_t used; // 最近一次命中的序号
+} EnemyTemplate;
+
+// 按 (属性, 等级, 种子) 缓存构建好的敌人，每个线程独占一份
+typedef struct EnemyCache {
+  EnemyTemplate *templates;
+  uint32_t mask; // 组数减一
+  uint64_t clock;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  const struct PresetTable *presets; // 构建模板使用的预设，为空时使用默认预设
+} EnemyCache;
+
+extern void buildEnemy(Energy *enemy, const struct PresetTable *presets,
+                       EnergyType type, int level, uint64_t seed);
+extern uint64_t enemyVariantSeed(uint64_t seed, uint64_t variant);
+extern int initEnemyCache(EnemyCache *cache, int capacity);
+extern void freeEnemyCache(EnemyCache *cache);
+extern void spawnEnemy(EnemyCache *cache, Energy *enemy, EnergyType type,
+                       int level, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENEMY_H
\ No newline at end of file
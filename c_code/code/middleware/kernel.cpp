@@ -0,0 +1,263 @@
+#include <array>
+#include <cstddef>
+#include <math.h>
+#include <utility>
+
+#include "attribute.h"
+#include "battle.h"
+#include "combat.h"
+#include "custom.h"
+#include "kernel.h"
+
+namespace {
+
+// 预设被动及其在纯攻击对局中可能派生的效果
+template <EnergyType Type> struct PresetEffects;
+
+template <> struct PresetEffects<METAL> {
+  static constexpr unsigned mask = EFFECT_BIT(strengthen);
+};
+
+// 受到法术伤害时叠加附魔
+template <> struct PresetEffects<WATER> {
+  static constexpr unsigned mask =
+      EFFECT_BIT(adjustAttribute) | EFFECT_BIT(enchanting);
+};
+
+template <> struct PresetEffects<WOOD> {
+  static constexpr unsigned mask = EFFECT_BIT(absorbBlood);
+};
+
+template <> struct PresetEffects<FIRE> {
+  static constexpr unsigned mask = EFFECT_BIT(enchanting);
+};
+
+// 受到伤害后积累物理、法术附加伤害
+template <> struct PresetEffects<EARTH> {
+  static constexpr unsigned mask = EFFECT_BIT(accumulateAnger) |
+                                   EFFECT_BIT(physicsAddition) |
+                                   EFFECT_BIT(magicAddition);
+};
+
+// 与 C 端 round() 相同，参数和结果都是 double，避免落到 float 重载
+inline double roundDouble(double x) { return ::round(x); }
+
+// 掩码在编译期为 0 的效果整段消失，其余仍按运行时状态判断
+template <unsigned Mask>
+inline bool expendEffect(Energy *energy, EffectID id) {
+  if (!(Mask & EFFECT_BIT(id)) || !EFFECT_ACTIVE(energy, id)) {
+    return false;
+  }
+  CombatEffect *effect = &energy->effects[id];
+  if (effect->type != infinite && --effect->times <= 0) {
+    energy->activeEffects &= ~EFFECT_BIT(id);
+  }
+  return true;
+}
+
+// 以下各函数与 combat.c 中的同名处理一一对应，只保留掩码内的效果
+template <unsigned Mask> int recoverHealth(Context *ctx, Energy *energy,
+                                           int recovery) {
+  int capacity = energy->capacityBase + energy->capacityExtra;
+  energy->health += recovery;
+  if (energy->health > capacity) {
+    recovery -= energy->health - capacity;
+    energy->health = capacity;
+  }
+
+  CombatEffect *effect = &energy->effects[adjustAttribute];
+  if (expendEffect<Mask>(energy, adjustAttribute)) {
+    double recoveryRatio = recovery / (double)energy->capacityBase;
+    double healthRatio = energy->health / (double)energy->capacityBase;
+    int adjustValue = curveAdjustValue(
+        &ctx->curve, energy->defenceBase * recoveryRatio, healthRatio);
+    energy->defenceOffset += adjustValue;
+    energy->attackOffset -= roundToInt(adjustValue * effect->value);
+  }
+  return recovery;
+}
+
+template <unsigned Mask> int deductHealth(Context *ctx, Energy *energy,
+                                          int damage, int damageType) {
+  energy->health -= damage;
+  if (energy->health < 0) {
+    damage += energy->health;
+    energy->health = 0;
+  }
+
+  CombatEffect *effect = &energy->effects[adjustAttribute];
+  if (expendEffect<Mask>(energy, adjustAttribute)) {
+    int health = energy->health + damage;
+    double damageRatio = damage / (double)energy->capacityBase;
+    double healthRatio = health / (double)energy->capacityBase;
+    int adjustValue = curveAdjustValue(
+        &ctx->curve, energy->defenceBase * damageRatio, healthRatio);
+    energy->defenceOffset -= adjustValue;
+    energy->attackOffset += roundToInt(adjustValue * effect->value);
+
+    if (damageType) {
+      effect = &energy->effects[enchanting];
+      effect->value += damageRatio;
+      setEffectTimes(energy, enchanting, effect->times + 1);
+    }
+  }
+
+  energy->capacityExtra -= damage;
+  if (energy->capacityExtra < 0) {
+    energy->capacityExtra = 0;
+  }
+
+  effect = &energy->effects[accumulateAnger];
+  if (expendEffect<Mask>(energy, accumulateAnger)) {
+    if (damageType) {
+      int addition = roundDouble(damage * effect->value * 0.3);
+      effect = &energy->effects[magicAddition];
+      effect->value += addition;
+      setEffectTimes(energy, magicAddition, 1);
+    } else {
+      int addition = roundDouble(damage * effect->value);
+      effect = &energy->effects[physicsAddition];
+      effect->value += addition;
+      setEffectTimes(energy, physicsAddition, 1);
+    }
+  }
+  return damage;
+}
+
+// 返回 1 表示防守方阵亡
+template <unsigned AttackerMask, unsigned DefenderMask>
+int attackOnce(Context *ctx, Energy *attacker, Energy *defender,
+               double attack, int defence, int damageType) {
+  if (attack <= 0) {
+    return 0;
+  }
+  int damage = defence > 0 ? roundDouble(attack * (attack / (attack + defence)))
+                           : roundDouble(attack - defence);
+
+  int actualDamage =
+      deductHealth<DefenderMask>(ctx, defender, damage, damageType);
+
+  CombatEffect *effect = &attacker->effects[absorbBlood];
+  if (damageType == 0 && expendEffect<AttackerMask>(attacker, absorbBlood)) {
+    recoverHealth<AttackerMask>(ctx, attacker,
+                                roundDouble(actualDamage * effect->value));
+  }
+  return defender->health <= 0;
+}
+
+template <EnergyType Attacker, EnergyType Defender>
+int combatKernel(Context *ctx, Energy *attacker, Energy *defender) {
+  constexpr unsigned attackerMask = PresetEffects<Attacker>::mask;
+  constexpr unsigned defenderMask = PresetEffects<Defender>::mask;
+
+  // 技能或道具带来的效果不在特化范围内
+  if ((attacker->activeEffects & ~attackerMask) ||
+      (defender->activeEffects & ~defenderMask)) {
+    return handleCombat(ctx, attacker, defender);
+  }
+
+  CombatEffect *effect;
+
+  int attack = attacker->attackBase + attacker->attackOffset;
+  effect = &attacker->effects[strengthen];
+  if (expendEffect<attackerMask>(attacker, strengthen)) {
+    attack += roundDouble(attack * effect->value);
+  }
+
+  int defence = defender->defenceBase + defender->defenceOffset;
+  effect = &defender->effects[strengthen];
+  if (expendEffect<defenderMask>(defender, strengthen)) {
+    defence += roundDouble(defence * effect->value);
+  }
+
+  double enchantRatio = 0.0;
+  effect = &attacker->effects[enchanting];
+  if (expendEffect<attackerMask>(attacker, enchanting)) {
+    if (effect->value > 1) {
+      effect->value = 1;
+    } else if (effect->value < 0) {
+      effect->value = 0;
+    }
+    enchantRatio = effect->value;
+    if (!EFFECT_ACTIVE(attacker, enchanting)) {
+      effect->value = 0;
+    }
+  }
+
+  double physicsAttack = attack * (1 - enchantRatio);
+  double magicAttack = attack * enchantRatio;
+
+  effect = &attacker->effects[physicsAddition];
+  if (expendEffect<attackerMask>(attacker, physicsAddition)) {
+    physicsAttack += effect->value;
+    effect->value = 0;
+  }
+  effect = &attacker->effects[magicAddition];
+  if (expendEffect<attackerMask>(attacker, magicAddition)) {
+    magicAttack += effect->value;
+    effect->value = 0;
+  }
+
+  if (attackOnce<attackerMask, defenderMask>(ctx, attacker, defender,
+                                             physicsAttack, defence, 0)) {
+    return 1;
+  }
+  return attackOnce<attackerMask, defenderMask>(ctx, attacker, defender,
+                                                magicAttack, 0, 1);
+}
+
+template <EnergyType Player, EnergyType Enemy>
+int battleKernel(Context *ctx, Energy *player, Energy *enemy) {
+  for (int fightTimes = 0; fightTimes < BATTLE_ROUND_LIMIT; ++fightTimes) {
+    if (combatKernel<Player, Enemy>(ctx, player, enemy) ||
+        combatKernel<Enemy, Player>(ctx, enemy, player)) {
+      break;
+    }
+  }
+  return enemy->health <= 0 ? player->health : -enemy->health;
+}
+
+typedef int (*BattleKernel)(Context *ctx, Energy *player, Energy *enemy);
+
+template <EnergyType Player, std::size_t... Enemies>
+constexpr std::array<BattleKernel, ENERGY_COUNT>
+kernelRow(std::index_sequence<Enemies...>) {
+  return {battleKernel<Player, (EnergyType)Enemies>...};
+}
+
+template <std::size_t... Players>
+constexpr std::array<std::array<BattleKernel, ENERGY_COUNT>, ENERGY_COUNT>
+kernelTable(std::index_sequence<Players...>) {
+  return {kernelRow<(EnergyType)Players>(
+      std::make_index_sequence<ENERGY_COUNT>())...};
+}
+
+// 25 个内核在编译期生成，按属性直接索引
+constexpr auto battleKernels =
+    kernelTable(std::make_index_sequence<ENERGY_COUNT>());
+
+// 特化按默认被动生成，预设表改了被动效果时只能走通用路径
+bool samePassives(const PresetTable *presets) {
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    if (presets->elements[i].passive != defaultPresets.elements[i].passive) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int canUseKernel(const Context *ctx) {
+  return ctx->trace == NULL && ctx->profiler == NULL &&
+         !LOG_ENABLED(ctx, LOG_BATTLE) &&
+         (ctx->presets == NULL || samePassives(ctx->presets));
+}
+
+int handleBattleKernel(Context *ctx, Energy *player, Energy *enemy) {
+  if (!canUseKernel(ctx) || (unsigned)player->type >= ENERGY_COUNT ||
+      (unsigned)enemy->type >= ENERGY_COUNT) {
+    return handleBattleOut(ctx, player, enemy);
+  }
+  return battleKernels[player->type][enemy->type](ctx, player, enemy);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "context.h"
+#include "energy.h"
+
+// 按 (玩家属性, 敌人属性) 在编译期特化的对战内核，规则与 handleBattleOut 相同
+// 只有预设被动及其派生效果会被展开，出现其他效果时该次出手回退到 handleCombat
+// 轨迹、日志和性能计数打开时整场回退到 handleBattleOut
+extern int canUseKernel(const Context *ctx);
+extern int handleBattleKernel(Context *ctx, Energy *player, Energy *enemy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KERNEL_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "custom.h"
+#include "pool.h"
+
+// 每个线程持有一段连续的任务编号，自己从前端取，空闲线程从后端窃取一半
+// 任务不会再产生新任务，所以一轮窃取全部失败即可退出
+typedef struct {
+  pthread_mutex_t lock;
+  long long begin;
+  long long end;
+} PoolRange;
+
+typedef struct {
+  int threads;
+  PoolRange *ranges;
+  PoolTask task;
+  void *data;
+  pthread_mutex_t statsLock;
+  PoolStats *stats;
+} Pool;
+
+typedef struct {
+  Pool *pool;
+  int index;
+  int started; // 线程创建失败时由调用线程执行
+  pthread_t thread;
+} PoolWorker;
+
+static int takeTask(PoolRange *range, long long *index) {
+  pthread_mutex_lock(&range->lock);
+  int ok = range->begin < range->end;
+  if (ok) {
+    *index = range->begin++;
+  }
+  pthread_mutex_unlock(&range->lock);
+  return ok;
+}
+
+// 从其他线程的后半段窃取任务放入自己的区间，返回窃取到的任务数
+static long long stealTasks(Pool *pool, int thief) {
+  for (int i = 1; i < pool->threads; ++i) {
+    PoolRange *victim = &pool->ranges[(thief + i) % pool->threads];
+    pthread_mutex_lock(&victim->lock);
+    long long remaining = victim->end - victim->begin;
+    long long begin = victim->end - (remaining + 1) / 2;
+    long long end = victim->end;
+    if (remaining > 0) {
+      victim->end = begin;
+    }
+    pthread_mutex_unlock(&victim->lock);
+
+    if (remaining > 0) {
+      PoolRange *own = &pool->ranges[thief];
+      pthread_mutex_lock(&own->lock);
+      own->begin = begin;
+      own->end = end;
+      pthread_mutex_unlock(&own->lock);
+      return end - begin;
+    }
+  }
+  return 0;
+}
+
+static void *runPoolWorker(void *arg) {
+  PoolWorker *worker = arg;
+  Pool *pool = worker->pool;
+  PoolRange *own = &pool->ranges[worker->index];
+  uint64_t steals = 0;
+  uint64_t stolenTasks = 0;
+
+  for (;;) {
+    long long index;
+    while (takeTask(own, &index)) {
+      pool->task(pool->data, worker->index, index);
+    }
+    long long stolen = stealTasks(pool, worker->index);
+    if (stolen == 0) {
+      break;
+    }
+    steals++;
+    stolenTasks += stolen;
+  }
+
+  if (pool->stats) {
+    pthread_mutex_lock(&pool->statsLock);
+    pool->stats->steals += steals;
+    pool->stats->stolenTasks += stolenTasks;
+    pthread_mutex_unlock(&pool->statsLock);
+  }
+  return NULL;
+}
+
+// 0 为按 CPU 核心数，且不多于任务数
+int resolvePoolThreads(int threads, long long tasks) {
+  threads = threads > 0 ? threads : getProcessorCount();
+  if (threads > tasks) {
+    threads = tasks > 0 ? tasks : 1;
+  }
+  return threads;
+}
+
+// 任务按编号平均分给各线程，耗时不均时由窃取重新平衡
+// 创建失败的线程由调用线程代为执行，只有内存不足时返回 0，此时没有执行任何任务
+int runPool(int threads, long long tasks, PoolTask task, void *data,
+            PoolStats *stats) {
+  threads = resolvePoolThreads(threads, tasks);
+  Pool pool = {.threads = threads, .task = task, .data = data, .stats = stats};
+  pool.ranges = calloc(threads, sizeof(PoolRange));
+  PoolWorker *workers = calloc(threads, sizeof(PoolWorker));
+  if (pool.ranges == NULL || workers == NULL) {
+    free(pool.ranges);
+    free(workers);
+    return 0;
+  }
+  if (stats) {
+    *stats = (PoolStats){.threads = threads};
+  }
+  pthread_mutex_init(&pool.statsLock, NULL);
+
+  for (int t = 0; t < threads; ++t) {
+    pthread_mutex_init(&pool.ranges[t].lock, NULL);
+    pool.ranges[t].begin = tasks * t / threads;
+    pool.ranges[t].end = tasks * (t + 1) / threads;
+  }
+  for (int t = 0; t < threads; ++t) {
+    workers[t] = (PoolWorker){.pool = &pool, .index = t};
+    workers[t].started = pthread_create(&workers[t].thread, NULL,
+                                        runPoolWorker, &workers[t]) == 0;
+  }
+  // 未启动线程的区间可能已被其他线程窃取，剩下的在这里做完
+  for (int t = 0; t < threads; ++t) {
+    if (!workers[t].started) {
+      runPoolWorker(&workers[t]);
+    }
+  }
+  for (int t = 0; t < threads; ++t) {
+    if (workers[t].started) {
+      pthread_join(workers[t].thread, NULL);
+    }
+  }
+
+  for (int t = 0; t < threads; ++t) {
+    pthread_mutex_destroy(&pool.ranges[t].lock);
+  }
+  pthread_mutex_destroy(&pool.statsLock);
+  free(pool.ranges);
+  free(workers);
+  return 1;
+}
\ No newline at end of file
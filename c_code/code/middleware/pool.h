@@ -0,0 +1,27 @@
+#ifndef POOL_H
+#define POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// 执行第 index 个任务，worker 为线程编号，可以用来索引线程独占的状态
+typedef void (*PoolTask)(void *data, int worker, long long index);
+
+typedef struct {
+  int threads;
+  uint64_t steals;       // 成功窃取的次数
+  uint64_t stolenTasks;  // 窃取到的任务总数
+} PoolStats;
+
+extern int resolvePoolThreads(int threads, long long tasks);
+extern int runPool(int threads, long long tasks, PoolTask task, void *data,
+                   PoolStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POOL_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "search.h"
+#include "solver.h"
+
+// 每搜索这么多节点检查一次时间
+#define SEARCH_CLOCK_INTERVAL 64
+
+static uint64_t nowNanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+int initSearch(DuelSearch *search, const SearchConfig *config) {
+  search->config = *config;
+  search->table = malloc(sizeof(SearchEntry) * SEARCH_TABLE_SIZE);
+  if (search->table == NULL) {
+    return 0;
+  }
+  for (int i = 0; i < SEARCH_TABLE_SIZE; ++i) {
+    search->table[i].depth = -1;
+    search->table[i].generation = 0;
+  }
+  initContext(&search->ctx, 0, LOG_NONE);
+  search->generation = 0;
+  search->nodes = 0;
+  search->moves = 0;
+  search->depthSum = 0;
+  return 1;
+}
+
+void freeSearch(DuelSearch *search) {
+  free(search->table);
+  search->table = NULL;
+}
+
+// 每场对局开始时调用：置换表整体作废、模拟用的随机序列复位，
+// 对局的结果因此与同一线程之前模拟过哪些对局无关
+void resetSearch(DuelSearch *search) {
+  search->generation++;
+  seedRandom(&search->ctx.random, 0);
+}
+
+// 局面估值：双方剩余生命比例之差，压缩在 (-1, 1) 内
+static double evaluate(const Energy *enemy, const Energy *player) {
+  double enemyRatio =
+      enemy->health / (double)(enemy->capacityBase + enemy->capacityExtra);
+  double playerRatio =
+      player->health / (double)(player->capacityBase + player->capacityExtra);
+  return (enemyRatio - playerRatio) / 2;
+}
+
+static int timeUp(DuelSearch *search) {
+  if (search->aborted) {
+    return 1;
+  }
+  ++search->nodes;
+  if (search->config.nodeBudget > 0) {
+    search->aborted = search->nodes >= search->nodeLimit;
+  } else if (search->nodes % SEARCH_CLOCK_INTERVAL == 0 &&
+             nowNanoseconds() >= search->deadline) {
+    search->aborted = 1;
+  }
+  return search->aborted;
+}
+
+// 期望最大化搜索：敌人取最大值，玩家按行为分布取期望
+// side[0] 为敌人，side[1] 为玩家，mover 为出手方
+static double expectimax(DuelSearch *search, const Energy side[2], int mover,
+                         int depth, Action *best) {
+  if (depth == 0 || timeUp(search)) {
+    return evaluate(&side[0], &side[1]);
+  }
+
+  uint64_t key;
+  uint64_t check;
+  hashDuel(&side[0], &side[1], mover, &key, &check);
+  SearchEntry *entry = &search->table[key & (SEARCH_TABLE_SIZE - 1)];
+  if (entry->generation == search->generation && entry->depth >= depth &&
+      entry->key == key && entry->check == check) {
+    if (entry->action >= 0) {
+      *best = entry->action;
+    }
+    return entry->value;
+  }
+
+  double value = mover == 0 ? -2 : 0;
+  for (int a = 0; a < ACTION_COUNT; ++a) {
+    Action action = a;
+    double probability = enemyActionProbability[action];
+    // 敌人不主动逃跑，玩家按分布出手
+    if (mover == 0 ? action == ESCAPE : probability <= 0) {
+      continue;
+    }
+
+    Energy next[2] = {side[0], side[1]};
+    int result =
+        handleAction(&search->ctx, &next[mover], &next[!mover], action);
+    double child;
+    if (result == ACTION_ESCAPED || result == -ACTION_ESCAPED) {
+      child = 0;
+    } else if (result != 0) {
+      child = (result > 0) == (mover == 0) ? 1 : -1;
+    } else {
+      Action reply = ATTACK;
+      child = expectimax(search, next, !mover, depth - 1, &reply);
+    }
+
+    if (mover == 1) {
+      value += probability * child;
+    } else if (child > value) {
+      value = child;
+      *best = action;
+    }
+  }
+
+  if (!search->aborted) {
+    entry->key = key;
+    entry->check = check;
+    entry->value = value;
+    entry->depth = depth;
+    entry->action = mover == 0 ? *best : -1; // 玩家节点只有期望值
+    entry->generation = search->generation;
+  }
+  return value;
+}
+
+// 在时间或节点预算内迭代加深，返回最后一次完整搜索的最优行为
+Action searchEnemyAction(DuelSearch *search, const Energy *enemy,
+                         const Energy *player) {
+  Energy side[2] = {*enemy, *player};
+  Action choice = ATTACK;
+  int completed = 0;
+
+  search->aborted = 0;
+  search->nodeLimit = search->nodes + search->config.nodeBudget;
+  if (search->config.nodeBudget <= 0) {
+    search->deadline = nowNanoseconds() + search->config.budget * 1000ull;
+  }
+  for (int depth = 1; depth <= search->config.maxDepth; ++depth) {
+    Action best = ATTACK;
+    expectimax(search, side, 0, depth, &best);
+    if (search->aborted) {
+      break;
+    }
+    choice = best;
+    completed = depth;
+  }
+
+  search->moves++;
+  search->depthSum += completed;
+  return choice;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "action.h"
+#include "context.h"
+#include "energy.h"
+
+// 置换表表项数，必须为 2 的幂
+#define SEARCH_TABLE_SIZE (1 << 16)
+
+// 每步的默认节点数上限，给定种子的模拟使用，约等于 20 微秒
+#define SEARCH_DEFAULT_NODES 128
+
+typedef struct {
+  int budget;     // 每步的搜索时间，微秒
+  int maxDepth;   // 最大搜索半回合数
+  int nodeBudget; // 大于 0 时按节点数而不是时间截止，结果只取决于种子
+} SearchConfig;
+
+typedef struct {
+  uint64_t key;
+  uint64_t check;
+  double value; // 敌人视角，胜 1 负 -1
+  int16_t depth; // 剩余搜索深度，-1 表示空表项
+  int16_t action;   // 敌人出手的节点才有，-1 表示无
+  uint32_t generation; // 与 DuelSearch 的代数不同时视为空表项
+} SearchEntry;
+
+// 敌人 AI 的搜索状态，每个线程独占一份
+typedef struct DuelSearch {
+  SearchConfig config;
+  SearchEntry *table;
+  Context ctx; // 模拟出手用，不记录日志也不消耗对局的随机数
+  uint64_t deadline; // 纳秒
+  uint64_t nodeLimit; // 按节点截止时本步的节点数上限
+  uint32_t generation;
+  uint64_t nodes;
+  uint64_t moves;
+  uint64_t depthSum; // 每步完成的搜索深度之和
+  int aborted;
+} DuelSearch;
+
+extern int initSearch(DuelSearch *search, const SearchConfig *config);
+extern void freeSearch(DuelSearch *search);
+extern void resetSearch(DuelSearch *search);
+extern Action searchEnemyAction(DuelSearch *search, const Energy *enemy,
+                                const Energy *player);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEARCH_H
\ No newline at end of file
@@ -0,0 +1,665 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "action.h"
+#include "attribute.h"
+#include "battle.h"
+#include "custom.h"
+#include "enemy.h"
+#include "simulation.h"
+#include "trace.h"
+
+// 95% 置信区间的 z 值
+#define CONFIDENCE_Z 1.96
+
+// 每场对局保留的轨迹事件数
+#define TRACE_CAPACITY 256
+
+#define CELL_COUNT (ENERGY_COUNT * ENERGY_COUNT)
+
+// 提前停止时每次分配的场数，也是判断是否停止的粒度
+#define SEQUENTIAL_CHUNK 256
+
+// 提前停止的调度状态，所有工作线程共享，访问时持有 lock
+// 每组的块按编号顺序并入统计，停止点只取决于结果，与线程数和调度无关
+typedef struct {
+  pthread_mutex_t lock;
+  int chunks;           // 每组最多的块数
+  MatchupStats *blocks; // [组][块] 已完成但尚未并入的结果
+  uint8_t *finished;    // [组][块]
+  TraceChunk *traces;   // [组][块] 暂存的轨迹，块并入时才写出
+  FILE *traceFile;      // 提前停止时只在持有 lock 时写入
+  int issued[CELL_COUNT];
+  int merged[CELL_COUNT];
+  uint8_t resolved[CELL_COUNT];
+  MatchupStats stats[CELL_COUNT]; // 按顺序并入的前缀
+} SequentialSchedule;
+
+typedef struct {
+  int index;
+  long long first;   // 本线程负责的第一场编号
+  long long battles; // 本线程负责的每组场数
+  const SimulationConfig *config;
+  MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT];
+  const PresetTable *candidate; // 以下只用于 A/B 对比
+  int antithetic;
+  PairedStats paired[ENERGY_COUNT][ENERGY_COUNT];
+  FILE *traceFile; // 所有线程共享，写入时持有 traceLock
+  pthread_mutex_t *traceLock;
+  SequentialSchedule *schedule; // 为空时按 first、battles 固定分配
+  pthread_t thread;
+} SimulationWorker;
+
+// 记录一场对局结果
+static void recordBattle(MatchupStats *stats, int result, int health,
+                         int rounds) {
+  stats->count++;
+  // 逃跑与回合耗尽一样不分胜负
+  if (result == ACTION_ESCAPED || result == -ACTION_ESCAPED) {
+    stats->draws++;
+  } else if (result > 0) {
+    stats->wins++;
+  } else if (result < 0) {
+    stats->losses++;
+  } else {
+    stats->draws++;
+  }
+  stats->healthSum += health;
+  stats->healthSquareSum += (double)health * health;
+  stats->roundSum += rounds;
+  stats->roundSquareSum += (double)rounds * rounds;
+}
+
+static void mergeStats(MatchupStats *target, const MatchupStats *source) {
+  target->count += source->count;
+  target->wins += source->wins;
+  target->losses += source->losses;
+  target->draws += source->draws;
+  target->healthSum += source->healthSum;
+  target->healthSquareSum += source->healthSquareSum;
+  target->roundSum += source->roundSum;
+  target->roundSquareSum += source->roundSquareSum;
+}
+
+// 每场对局使用独立的随机流，编号由对阵组合和场次拼成
+static uint64_t battleStream(EnergyType playerType, EnergyType enemyType,
+                             long long index) {
+  return ((uint64_t)(playerType * ENERGY_COUNT + enemyType) << 48) |
+         (uint64_t)index;
+}
+
+// mirror 为 1 时使用第 index 场随机序列的对偶序列
+static int playBattle(Context *ctx, const SimulationConfig *config,
+                      EnergyType playerType, EnergyType enemyType,
+                      long long index, int mirror, int *health, int *rounds) {
+  seedRandomStream(&ctx->random, config->seed,
+                   battleStream(playerType, enemyType, index));
+  if (mirror) {
+    mirrorRandom(&ctx->random);
+  }
+  if (ctx->search) {
+    resetSearch(ctx->search);
+  }
+
+  Energy player = {.name = "player", .type = playerType};
+  Energy enemy = {.name = "enemy", .type = enemyType};
+  if (ctx->trace) {
+    beginTrace(ctx->trace, &player, &enemy);
+  }
+  getPresetsAttributes(ctx, &player);
+  upgradeRandom(ctx, &player, config->playerLevel);
+  if (config->enemyVariants > 0) {
+    // 敌人只取决于变体编号，不消耗本场对局的随机序列
+    uint64_t variant =
+        enemyVariantSeed(config->seed, index % config->enemyVariants);
+    if (ctx->enemies) {
+      spawnEnemy(ctx->enemies, &enemy, enemyType, config->enemyLevel,
+                 variant);
+    } else {
+      buildEnemy(&enemy, config->presets, enemyType, config->enemyLevel,
+                 variant);
+    }
+  } else {
+    getPresetsAttributes(ctx, &enemy);
+    upgradeRandom(ctx, &enemy, config->enemyLevel);
+  }
+
+  int result = handleBattleAuto(ctx, &player, &enemy, rounds);
+  *health = player.health;
+  return result;
+}
+
+int simulateBattle(Context *ctx, const SimulationConfig *config,
+                   EnergyType playerType, EnergyType enemyType,
+                   long long index, int *health, int *rounds) {
+  return playBattle(ctx, config, playerType, enemyType, index, 0, health,
+                    rounds);
+}
+
+// 模拟一组对局中 [first, last) 的场次，pending 非空时轨迹先暂存在其中
+static void playRange(SimulationWorker *worker, Context *ctx,
+                      EnergyType playerType, EnergyType enemyType,
+                      long long first, long long last, MatchupStats *stats,
+                      TraceChunk *pending) {
+  for (long long n = first; n < last; ++n) {
+    int health = 0;
+    int rounds = 0;
+    int result = simulateBattle(ctx, worker->config, playerType, enemyType, n,
+                                &health, &rounds);
+    recordBattle(stats, result, health, rounds);
+
+    if (ctx->trace && pending) {
+      packTrace(pending, ctx->trace, n, playerType, enemyType, result);
+    } else if (ctx->trace) {
+      pthread_mutex_lock(worker->traceLock);
+      writeTrace(ctx->trace, worker->traceFile, n, playerType, enemyType,
+                 result);
+      pthread_mutex_unlock(worker->traceLock);
+    }
+  }
+}
+
+// 胜率的 95% 置信区间半宽不超过 tolerance 时停止，
+// 胜率取 (wins + 0.5) / (count + 1)，一边倒的组合不会因为方差为 0 过早停止
+static int isResolved(const MatchupStats *stats, double tolerance) {
+  double rate = (stats->wins + 0.5) / (stats->count + 1);
+  return CONFIDENCE_Z * sqrt(rate * (1 - rate) / stats->count) <= tolerance;
+}
+
+// 分配已分配块数最少的未停止组合，不确定的组合因此分到更多的线程
+static int nextChunk(SequentialSchedule *schedule, int *chunk) {
+  int cell = -1;
+  for (int c = 0; c < CELL_COUNT; ++c) {
+    if (!schedule->resolved[c] && schedule->issued[c] < schedule->chunks &&
+        (cell < 0 || schedule->issued[c] < schedule->issued[cell])) {
+      cell = c;
+    }
+  }
+  if (cell >= 0) {
+    *chunk = schedule->issued[cell]++;
+  }
+  return cell;
+}
+
+// 按编号顺序并入已完成的块，停止后到达的块直接丢弃
+// 轨迹随块一起并入，被丢弃的块不会出现在轨迹文件中
+static void commitChunk(SequentialSchedule *schedule, int cell, int chunk,
+                        const MatchupStats *result, TraceChunk *pending,
+                        double tolerance) {
+  int base = cell * schedule->chunks;
+  if (schedule->resolved[cell]) {
+    return;
+  }
+  schedule->blocks[base + chunk] = *result;
+  schedule->finished[base + chunk] = 1;
+  if (schedule->traces) {
+    schedule->traces[base + chunk] = *pending;
+    *pending = (TraceChunk){0};
+  }
+  while (!schedule->resolved[cell] &&
+         schedule->finished[base + schedule->merged[cell]]) {
+    int block = base + schedule->merged[cell];
+    mergeStats(&schedule->stats[cell], &schedule->blocks[block]);
+    if (schedule->traces) {
+      flushTraceChunk(&schedule->traces[block], schedule->traceFile);
+      freeTraceChunk(&schedule->traces[block]);
+    }
+    schedule->merged[cell]++;
+    if (schedule->merged[cell] == schedule->chunks ||
+        isResolved(&schedule->stats[cell], tolerance)) {
+      schedule->resolved[cell] = 1;
+    }
+  }
+}
+
+static void runSequential(SimulationWorker *worker, Context *ctx) {
+  SequentialSchedule *schedule = worker->schedule;
+  const SimulationConfig *config = worker->config;
+
+  pthread_mutex_lock(&schedule->lock);
+  int chunk = 0;
+  int cell;
+  while ((cell = nextChunk(schedule, &chunk)) >= 0) {
+    pthread_mutex_unlock(&schedule->lock);
+
+    MatchupStats result = {0};
+    TraceChunk pending = {0};
+    long long first = (long long)chunk * SEQUENTIAL_CHUNK;
+    long long last = first + SEQUENTIAL_CHUNK < config->battles
+                         ? first + SEQUENTIAL_CHUNK
+                         : config->battles;
+    playRange(worker, ctx, cell / ENERGY_COUNT, cell % ENERGY_COUNT, first,
+              last, &result, ctx->trace ? &pending : NULL);
+
+    pthread_mutex_lock(&schedule->lock);
+    commitChunk(schedule, cell, chunk, &result, &pending, config->tolerance);
+    freeTraceChunk(&pending);
+  }
+  pthread_mutex_unlock(&schedule->lock);
+}
+
+// 工作线程：每组对局模拟分配到的场数，结果只写入线程自身的统计
+// 提前停止时改为从共享调度中领取块
+static void *runWorker(void *arg) {
+  SimulationWorker *worker = arg;
+  const SimulationConfig *config = worker->config;
+
+  Context ctx;
+  initContext(&ctx, config->seed, LOG_NONE);
+  ctx.presets = config->presets;
+  if (config->curve) {
+    ctx.curve = *config->curve;
+  }
+
+  TraceBuffer trace;
+  if (worker->traceFile && initTrace(&trace, TRACE_CAPACITY)) {
+    ctx.trace = &trace;
+  }
+
+  DuelSearch search;
+  if (config->enemySearch && initSearch(&search, config->enemySearch)) {
+    ctx.search = &search;
+  }
+
+  EnemyCache enemies;
+  if (config->enemyVariants > 0 &&
+      initEnemyCache(&enemies, ENERGY_COUNT * config->enemyVariants)) {
+    enemies.presets = config->presets;
+    ctx.enemies = &enemies;
+  }
+
+  if (worker->schedule) {
+    runSequential(worker, &ctx);
+  } else {
+    for (int i = 0; i < ENERGY_COUNT; ++i) {
+      for (int j = 0; j < ENERGY_COUNT; ++j) {
+        playRange(worker, &ctx, i, j, worker->first,
+                  worker->first + worker->battles, &worker->stats[i][j],
+                  NULL);
+      }
+    }
+  }
+
+  if (ctx.trace) {
+    freeTrace(ctx.trace);
+  }
+  if (ctx.search) {
+    freeSearch(ctx.search);
+  }
+  if (ctx.enemies) {
+    freeEnemyCache(ctx.enemies);
+  }
+
+  return NULL;
+}
+
+static SequentialSchedule *createSchedule(long long battles,
+                                          FILE *traceFile) {
+  SequentialSchedule *schedule = calloc(1, sizeof(SequentialSchedule));
+  if (schedule == NULL) {
+    return NULL;
+  }
+  schedule->chunks = (battles + SEQUENTIAL_CHUNK - 1) / SEQUENTIAL_CHUNK;
+  size_t blocks = (size_t)schedule->chunks * CELL_COUNT + 1;
+  schedule->blocks = calloc(blocks, sizeof(MatchupStats));
+  schedule->finished = calloc(blocks, 1);
+  if (traceFile) {
+    schedule->traces = calloc(blocks, sizeof(TraceChunk));
+    schedule->traceFile = traceFile;
+  }
+  if (schedule->blocks == NULL || schedule->finished == NULL ||
+      (traceFile && schedule->traces == NULL)) {
+    free(schedule->blocks);
+    free(schedule->finished);
+    free(schedule->traces);
+    free(schedule);
+    return NULL;
+  }
+  pthread_mutex_init(&schedule->lock, NULL);
+  return schedule;
+}
+
+static void freeSchedule(SequentialSchedule *schedule) {
+  pthread_mutex_destroy(&schedule->lock);
+  if (schedule->traces) {
+    for (long long b = 0; b < (long long)schedule->chunks * CELL_COUNT; ++b) {
+      freeTraceChunk(&schedule->traces[b]);
+    }
+    free(schedule->traces);
+  }
+  free(schedule->blocks);
+  free(schedule->finished);
+  free(schedule);
+}
+
+void simulateMatchups(const SimulationConfig *config,
+                      MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  int threads = config->threads > 0 ? config->threads : getProcessorCount();
+  if (threads > config->battles) {
+    threads = config->battles > 0 ? config->battles : 1;
+  }
+
+  SimulationWorker *workers = calloc(threads, sizeof(SimulationWorker));
+  if (workers == NULL) {
+    return;
+  }
+
+  FILE *traceFile = NULL;
+  pthread_mutex_t traceLock;
+  if (config->tracePath) {
+    traceFile = fopen(config->tracePath, "wb");
+    if (traceFile) {
+      writeTraceHeader(traceFile);
+    }
+  }
+  pthread_mutex_init(&traceLock, NULL);
+
+  SequentialSchedule *schedule = NULL;
+  if (config->tolerance > 0) {
+    schedule = createSchedule(config->battles, traceFile);
+  }
+
+  long long first = 0;
+  for (int t = 0; t < threads; ++t) {
+    workers[t].index = t;
+    workers[t].config = config;
+    workers[t].traceFile = traceFile;
+    workers[t].traceLock = &traceLock;
+    workers[t].schedule = schedule;
+    workers[t].first = first;
+    workers[t].battles =
+        config->battles / threads + (t < config->battles % threads);
+    first += workers[t].battles;
+    pthread_create(&workers[t].thread, NULL, runWorker, &workers[t]);
+  }
+
+  memset(stats, 0, sizeof(MatchupStats) * ENERGY_COUNT * ENERGY_COUNT);
+  for (int t = 0; t < threads; ++t) {
+    pthread_join(workers[t].thread, NULL);
+    for (int i = 0; i < ENERGY_COUNT; ++i) {
+      for (int j = 0; j < ENERGY_COUNT; ++j) {
+        mergeStats(&stats[i][j], &workers[t].stats[i][j]);
+      }
+    }
+  }
+  if (schedule) {
+    memcpy(stats, schedule->stats, sizeof(schedule->stats));
+    freeSchedule(schedule);
+  }
+
+  if (traceFile) {
+    fclose(traceFile);
+  }
+  pthread_mutex_destroy(&traceLock);
+  free(workers);
+}
+
+// 逃跑与回合耗尽按平局计半分
+static double battleScore(int result) {
+  if (result == ACTION_ESCAPED || result == -ACTION_ESCAPED || result == 0) {
+    return 0.5;
+  }
+  return result > 0 ? 1 : 0;
+}
+
+static void recordPair(PairedStats *stats, double baseline,
+                       double candidate) {
+  double difference = candidate - baseline;
+  stats->count++;
+  stats->baselineSum += baseline;
+  stats->baselineSquareSum += baseline * baseline;
+  stats->candidateSum += candidate;
+  stats->candidateSquareSum += candidate * candidate;
+  stats->differenceSum += difference;
+  stats->differenceSquareSum += difference * difference;
+}
+
+static void mergePaired(PairedStats *target, const PairedStats *source) {
+  target->count += source->count;
+  target->baselineSum += source->baselineSum;
+  target->baselineSquareSum += source->baselineSquareSum;
+  target->candidateSum += source->candidateSum;
+  target->candidateSquareSum += source->candidateSquareSum;
+  target->differenceSum += source->differenceSum;
+  target->differenceSquareSum += source->differenceSquareSum;
+}
+
+// 在同一场次的随机序列上分别用基准和候选预设对局，两边的噪声相互抵消
+// 对偶模式再加一场对偶序列的对局，与原场取平均作为一个样本
+static double playScore(Context *ctx, const SimulationConfig *config,
+                        EnergyType playerType, EnergyType enemyType,
+                        long long index, int antithetic) {
+  int health = 0;
+  int rounds = 0;
+  double score = battleScore(playBattle(ctx, config, playerType, enemyType,
+                                        index, 0, &health, &rounds));
+  if (antithetic) {
+    score += battleScore(playBattle(ctx, config, playerType, enemyType, index,
+                                    1, &health, &rounds));
+    score /= 2;
+  }
+  return score;
+}
+
+static void *runComparisonWorker(void *arg) {
+  SimulationWorker *worker = arg;
+  const SimulationConfig *baseline = worker->config;
+  SimulationConfig candidate = *baseline;
+  candidate.presets = worker->candidate;
+
+  // 两边各用一份上下文与敌人缓存，模板由各自的预设构建
+  Context contexts[2];
+  EnemyCache enemies[2];
+  const SimulationConfig *configs[2] = {baseline, &candidate};
+  for (int k = 0; k < 2; ++k) {
+    initContext(&contexts[k], baseline->seed, LOG_NONE);
+    contexts[k].presets = configs[k]->presets;
+    if (baseline->curve) {
+      contexts[k].curve = *baseline->curve;
+    }
+    if (baseline->enemyVariants > 0 &&
+        initEnemyCache(&enemies[k], ENERGY_COUNT * baseline->enemyVariants)) {
+      enemies[k].presets = configs[k]->presets;
+      contexts[k].enemies = &enemies[k];
+    }
+  }
+
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      long long last = worker->first + worker->battles;
+      for (long long n = worker->first; n < last; ++n) {
+        double scores[2];
+        for (int k = 0; k < 2; ++k) {
+          scores[k] = playScore(&contexts[k], configs[k], i, j, n,
+                                worker->antithetic);
+        }
+        recordPair(&worker->paired[i][j], scores[0], scores[1]);
+      }
+    }
+  }
+
+  for (int k = 0; k < 2; ++k) {
+    if (contexts[k].enemies) {
+      freeEnemyCache(contexts[k].enemies);
+    }
+  }
+  return NULL;
+}
+
+// config 的预设为基准，轨迹与敌人 AI 不参与对比
+void compareMatchups(const SimulationConfig *config,
+                     const PresetTable *candidate, int antithetic,
+                     PairedStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  int threads = config->threads > 0 ? config->threads : getProcessorCount();
+  if (threads > config->battles) {
+    threads = config->battles > 0 ? config->battles : 1;
+  }
+
+  memset(stats, 0, sizeof(PairedStats) * ENERGY_COUNT * ENERGY_COUNT);
+  SimulationWorker *workers = calloc(threads, sizeof(SimulationWorker));
+  if (workers == NULL) {
+    return;
+  }
+
+  long long first = 0;
+  for (int t = 0; t < threads; ++t) {
+    workers[t].index = t;
+    workers[t].config = config;
+    workers[t].candidate = candidate;
+    workers[t].antithetic = antithetic;
+    workers[t].first = first;
+    workers[t].battles =
+        config->battles / threads + (t < config->battles % threads);
+    first += workers[t].battles;
+    pthread_create(&workers[t].thread, NULL, runComparisonWorker,
+                   &workers[t]);
+  }
+
+  for (int t = 0; t < threads; ++t) {
+    pthread_join(workers[t].thread, NULL);
+    for (int i = 0; i < ENERGY_COUNT; ++i) {
+      for (int j = 0; j < ENERGY_COUNT; ++j) {
+        mergePaired(&stats[i][j], &workers[t].paired[i][j]);
+      }
+    }
+  }
+  free(workers);
+}
+
+// 计算均值及其 95% 置信区间半宽
+static double meanInterval(double sum, double squareSum, long long count,
+                           double *halfWidth) {
+  if (count <= 0) {
+    *halfWidth = 0;
+    return 0;
+  }
+  double mean = sum / count;
+  double variance = count > 1 ? (squareSum - sum * mean) / (count - 1) : 0;
+  *halfWidth = CONFIDENCE_Z * sqrt(variance > 0 ? variance / count : 0);
+  return mean;
+}
+
+static void printTableHeader(const char *title) {
+  printf("%s:\n", title);
+  printf("%-10s", " ");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-18s", energyNames[i]);
+  }
+  printf("\n");
+}
+
+void printMatchupStats(const MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  double halfWidth;
+
+  printTableHeader("win rate % (95% CI)");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const MatchupStats *cell = &stats[i][j];
+      double rate = cell->count ? cell->wins / (double)cell->count : 0;
+      halfWidth = cell->count
+                      ? CONFIDENCE_Z * sqrt(rate * (1 - rate) / cell->count)
+                      : 0;
+      printf("%6.2f ±%-9.2f", rate * 100, halfWidth * 100);
+    }
+    printf("\n");
+  }
+
+  printTableHeader("remaining health (95% CI)");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const MatchupStats *cell = &stats[i][j];
+      double mean = meanInterval(cell->healthSum, cell->healthSquareSum,
+                                 cell->count, &halfWidth);
+      printf("%7.1f ±%-8.1f", mean, halfWidth);
+    }
+    printf("\n");
+  }
+
+  printTableHeader("rounds (95% CI)");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const MatchupStats *cell = &stats[i][j];
+      double mean = meanInterval(cell->roundSum, cell->roundSquareSum,
+                                 cell->count, &halfWidth);
+      printf("%7.2f ±%-8.2f", mean, halfWidth);
+    }
+    printf("\n");
+  }
+}
+
+// 提前停止时各组实际计入的场数
+void printMatchupCounts(const MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  printTableHeader("battles");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      printf("%9lld         ", stats[i][j].count);
+    }
+    printf("\n");
+  }
+}
+
+// 方差缩减为两次独立模拟的差值方差与配对差值方差之比，
+// 即独立模拟要达到同样的置信区间需要多少倍的场数
+void printPairedStats(const PairedStats stats[ENERGY_COUNT][ENERGY_COUNT]) {
+  double halfWidth;
+
+  printTableHeader("candidate - baseline score % (95% CI)");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const PairedStats *cell = &stats[i][j];
+      double mean = meanInterval(cell->differenceSum,
+                                 cell->differenceSquareSum, cell->count,
+                                 &halfWidth);
+      printf("%+6.2f ±%-9.2f", mean * 100, halfWidth * 100);
+    }
+    printf("\n");
+  }
+
+  printTableHeader("variance reduction");
+  PairedStats total = {0};
+  double independent = 0;
+  double paired = 0;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      const PairedStats *cell = &stats[i][j];
+      double baseline, candidate, difference;
+      meanInterval(cell->baselineSum, cell->baselineSquareSum, cell->count,
+                   &baseline);
+      meanInterval(cell->candidateSum, cell->candidateSquareSum, cell->count,
+                   &candidate);
+      meanInterval(cell->differenceSum, cell->differenceSquareSum,
+                   cell->count, &difference);
+      double spread = baseline * baseline + candidate * candidate;
+      double variance = difference * difference;
+      if (variance > 0) {
+        printf("%8.1fx         ", spread / variance);
+      } else {
+        printf("%9s         ", spread > 0 ? "inf" : "-");
+      }
+      independent += spread;
+      paired += variance;
+      mergePaired(&total, cell);
+    }
+    printf("\n");
+  }
+
+  double baseline = total.count ? total.baselineSum / total.count : 0;
+  double candidate = total.count ? total.candidateSum / total.count : 0;
+  // 各组样本数相同，总体差值的方差为各组方差之和除以组数的平方
+  int cells = ENERGY_COUNT * ENERGY_COUNT;
+  printf("overall score %.2f%% -> %.2f%%, difference %+.3f ±%.3f%%, "
+         "variance reduction %.1fx\n",
+         baseline * 100, candidate * 100, (candidate - baseline) * 100,
+         sqrt(paired) / cells * 100,
+         paired > 0 ? independent / paired : 0);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "attribute.h"
+#include "context.h"
+#include "energy.h"
+#include "search.h"
+
+typedef struct {
+  long long battles; // 每组对局的模拟场数
+  int threads;       // 工作线程数，0 为按 CPU 核心数
+  int playerLevel;
+  int enemyLevel;
+  uint64_t seed;      // 第 N 场对局的随机序列只由种子和 N 决定
+  const char *tracePath; // 二进制事件轨迹输出文件，为空时不记录
+  const SearchConfig *enemySearch; // 敌人 AI，为空时敌人随机出手
+  int enemyVariants; // 大于 0 时敌人取自模板缓存，每组只有这么多种
+  const PresetTable *presets; // 属性预设，为空时使用默认预设
+  const CurveConfig *curve;   // 调整属性曲线，为空时使用默认曲线
+  double tolerance; // 大于 0 时每组胜率的 95% 置信区间半宽到此即停止，
+                    // battles 为每组的上限
+} SimulationConfig;
+
+typedef struct {
+  long long count;
+  long long wins;
+  long long losses;
+  long long draws;
+  double healthSum; // 玩家剩余生命值
+  double healthSquareSum;
+  double roundSum; // 对局回合数
+  double roundSquareSum;
+} MatchupStats;
+
+// 同一随机序列下基准与候选预设的配对结果，得分为胜 1、平 0.5、负 0
+typedef struct {
+  long long count; // 配对样本数，对偶模式下正反两场合为一个样本
+  double baselineSum;
+  double baselineSquareSum;
+  double candidateSum;
+  double candidateSquareSum;
+  double differenceSum; // 候选减基准
+  double differenceSquareSum;
+} PairedStats;
+
+extern int simulateBattle(Context *ctx, const SimulationConfig *config,
+                          EnergyType playerType, EnergyType enemyType,
+                          long long index, int *health, int *rounds);
+extern void simulateMatchups(const SimulationConfig *config,
+                             MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+extern void
+printMatchupStats(const MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+extern void
+printMatchupCounts(const MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+extern void compareMatchups(const SimulationConfig *config,
+                            const PresetTable *candidate, int antithetic,
+                            PairedStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+extern void
+printPairedStats(const PairedStats stats[ENERGY_COUNT][ENERGY_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMULATION_H
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "action.h"
+#include "battle.h"
+#include "solver.h"
+
+// 参与哈希的字节数，名称只用于显示
+#define STATE_SIZE offsetof(Energy, name)
+
+int initSolver(DuelSolver *solver, size_t memory) {
+  uint64_t buckets = 1;
+  while (buckets * 2 * SOLVER_BUCKET * sizeof(SolverEntry) <= memory) {
+    buckets *= 2;
+  }
+  memset(solver, 0, sizeof(DuelSolver));
+  solver->entries = calloc(buckets * SOLVER_BUCKET, sizeof(SolverEntry));
+  solver->mask = buckets - 1;
+  solver->cutoff = SOLVER_CUTOFF;
+  initContext(&solver->ctx, 0, LOG_NONE);
+  return solver->entries != NULL;
+}
+
+void freeSolver(DuelSolver *solver) {
+  free(solver->entries);
+  solver->entries = NULL;
+}
+
+static uint64_t mixWord(uint64_t hash, uint64_t word, uint64_t multiplier) {
+  hash = (hash ^ word) * multiplier;
+  return hash ^ (hash >> 29);
+}
+
+// 两个独立的 64 位哈希，误判的概率约为 2^-128 乘以状态数的平方
+// salt 区分出手方和回合等不在 Energy 中的状态
+void hashDuel(const Energy *player, const Energy *enemy, int salt,
+              uint64_t *key, uint64_t *check) {
+  const Energy *sides[2] = {player, enemy};
+  uint64_t first = 0x243F6A8885A308D3ull ^ (uint64_t)salt;
+  uint64_t second = 0x13198A2E03707344ull + (uint64_t)salt;
+  for (int s = 0; s < 2; ++s) {
+    const unsigned char *bytes = (const unsigned char *)sides[s];
+    for (size_t i = 0; i < STATE_SIZE; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(word));
+      first = mixWord(first, word, 0x9E3779B97F4A7C15ull);
+      second = mixWord(second, word, 0xC2B2AE3D27D4EB4Full);
+    }
+  }
+  *key = first;
+  *check = second;
+}
+
+static const SolverEntry *findEntry(DuelSolver *solver, uint64_t key,
+                                    uint64_t check) {
+  SolverEntry *bucket = &solver->entries[(key & solver->mask) * SOLVER_BUCKET];
+  for (int i = 0; i < SOLVER_BUCKET; ++i) {
+    if (bucket[i].half && bucket[i].key == key && bucket[i].check == check) {
+      return &bucket[i];
+    }
+  }
+  return NULL;
+}
+
+// 同一状态以更高的到达概率重新求解时覆盖原表项
+static void storeEntry(DuelSolver *solver, uint64_t key, uint64_t check,
+                       int half, float reach, const DuelOdds *odds) {
+  SolverEntry *bucket = &solver->entries[(key & solver->mask) * SOLVER_BUCKET];
+  SolverEntry *victim = NULL;
+  for (int i = 0; i < SOLVER_BUCKET; ++i) {
+    if (bucket[i].half && bucket[i].key == key && bucket[i].check == check) {
+      victim = &bucket[i];
+      break;
+    }
+  }
+  if (victim == NULL) {
+    victim = &bucket[0];
+    for (int i = 0; i < SOLVER_BUCKET; ++i) {
+      if (bucket[i].half == 0) {
+        victim = &bucket[i];
+        break;
+      }
+      if (bucket[i].half > victim->half) {
+        victim = &bucket[i];
+      }
+    }
+    if (victim->half) {
+      solver->evictions++;
+    }
+  }
+  victim->key = key;
+  victim->check = check;
+  victim->odds = *odds;
+  victim->half = half + 1;
+  victim->reach = reach;
+}
+
+// mover 为 0 时玩家出手，half 为已进行的半回合数，reach 为到达本状态的概率
+static DuelOdds solveState(DuelSolver *solver, const Energy *player,
+                           const Energy *enemy, int mover, int half,
+                           double reach) {
+  DuelOdds odds = {0, 0, 0, 0};
+  if (half >= BATTLE_ROUND_LIMIT * 2) {
+    odds.draw = 1;
+    return odds;
+  }
+  if (reach < solver->cutoff) {
+    odds.unresolved = 1;
+    return odds;
+  }
+
+  uint64_t key;
+  uint64_t check;
+  hashDuel(player, enemy, half * 2 + mover, &key, &check);
+  // 表项在更低的到达概率下截断得更深，没有截断或到达概率不更高时可以直接使用
+  float nodeReach = (float)reach;
+  const SolverEntry *entry = findEntry(solver, key, check);
+  if (entry && (entry->odds.unresolved == 0 || nodeReach <= entry->reach)) {
+    solver->hits++;
+    return entry->odds;
+  }
+  solver->states++;
+
+  for (int a = 0; a < ACTION_COUNT; ++a) {
+    double probability = enemyActionProbability[a];
+    if (probability <= 0) {
+      continue;
+    }
+    Energy next[2] = {*player, *enemy};
+    int result = handleAction(&solver->ctx, &next[mover], &next[!mover], a);
+    if (result == ACTION_ESCAPED || result == -ACTION_ESCAPED) {
+      odds.draw += probability; // 逃跑不分胜负
+      continue;
+    }
+    if (result != 0) {
+      // 结果以出手方为视角
+      if ((result > 0) == (mover == 0)) {
+        odds.win += probability;
+      } else {
+        odds.lose += probability;
+      }
+      continue;
+    }
+    DuelOdds child = solveState(solver, &next[0], &next[1], !mover, half + 1,
+                                reach * probability);
+    odds.win += probability * child.win;
+    odds.lose += probability * child.lose;
+    odds.draw += probability * child.draw;
+    odds.unresolved += probability * child.unresolved;
+  }
+
+  storeEntry(solver, key, check, half, nodeReach, &odds);
+  return odds;
+}
+
+// 与 handleBattleAuto 相同的规则：先手各占一半，双方都按敌人行为分布出手
+// 各项概率是精确值的下界，与真实值的差不超过 unresolved
+DuelOdds solveDuel(DuelSolver *solver, const Energy *player,
+                   const Energy *enemy) {
+  DuelOdds lead[2];
+  for (int mover = 0; mover < 2; ++mover) {
+    lead[mover] = solveState(solver, player, enemy, mover, 0, 0.5);
+  }
+  DuelOdds odds = {(lead[0].win + lead[1].win) / 2,
+                   (lead[0].lose + lead[1].lose) / 2,
+                   (lead[0].draw + lead[1].draw) / 2,
+                   (lead[0].unresolved + lead[1].unresolved) / 2};
+  return odds;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "context.h"
+#include "energy.h"
+
+// 每个桶的表项数，桶满时淘汰离终局最近 (重算最便宜) 的表项
+#define SOLVER_BUCKET 4
+// 到达概率低于此值的状态不再展开，计入 unresolved
+#define SOLVER_CUTOFF 1e-6
+
+typedef struct {
+  double win; // 玩家视角
+  double lose;
+  double draw;       // 回合耗尽或逃跑
+  double unresolved; // 被截断未展开的概率
+} DuelOdds;
+
+// 状态只保存两个 128 位内的指纹，不保存完整的 Energy
+typedef struct {
+  uint64_t key;
+  uint64_t check;
+  DuelOdds odds;
+  int32_t half; // 已进行的半回合数，0 表示空表项
+  float reach;  // 求解时的到达概率，越高截断越少
+} SolverEntry;
+
+typedef struct {
+  SolverEntry *entries;
+  uint64_t mask; // 桶数减一
+  uint64_t states;
+  uint64_t hits;
+  uint64_t evictions;
+  double cutoff; // 默认为 SOLVER_CUTOFF，设为 0 则完全展开 (状态数指数增长)
+  Context ctx; // 只用于调用 handleAction，不记录日志
+} DuelSolver;
+
+extern void hashDuel(const Energy *player, const Energy *enemy, int salt,
+                     uint64_t *key, uint64_t *check);
+extern int initSolver(DuelSolver *solver, size_t memory);
+extern void freeSolver(DuelSolver *solver);
+extern DuelOdds solveDuel(DuelSolver *solver, const Energy *player,
+                          const Energy *enemy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOLVER_H
\ No newline at end of file
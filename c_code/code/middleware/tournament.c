@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "action.h"
+#include "simulation.h"
+#include "tournament.h"
+
+typedef struct {
+  const GridConfig *config;
+  LevelGrid *grid;
+  Context *contexts; // 每个线程一份
+} GridJob;
+
+int getGridLevels(const GridConfig *config) {
+  return config->levelStep > 0 ? config->maxLevel / config->levelStep + 1 : 1;
+}
+
+// 每格的随机序列必须互不重叠
+int checkGridConfig(const GridConfig *config) {
+  return config->battles >= 0 && config->battles <= GRID_MAX_BATTLES &&
+         config->maxLevel >= 0 && getGridLevels(config) <= GRID_MAX_LEVELS;
+}
+
+GridCell *getGridCell(const LevelGrid *grid, EnergyType playerType,
+                      EnergyType enemyType, int playerLevel, int enemyLevel) {
+  long long index = (long long)(playerType * ENERGY_COUNT + enemyType) *
+                        grid->levels * grid->levels +
+                    (long long)playerLevel * grid->levels + enemyLevel;
+  return &grid->cells[index];
+}
+
+// 一个任务为一格，高等级的格子回合数多，耗时可以相差数十倍
+static void playGridCell(void *data, int worker, long long index) {
+  GridJob *job = data;
+  const GridConfig *config = job->config;
+  int levels = job->grid->levels;
+  int enemyLevel = index % levels;
+  int playerLevel = index / levels % levels;
+  int pair = index / ((long long)levels * levels);
+
+  SimulationConfig simulation = {
+      .seed = config->seed,
+      .playerLevel = playerLevel * config->levelStep,
+      .enemyLevel = enemyLevel * config->levelStep,
+      .presets = config->presets};
+  Context *ctx = &job->contexts[worker];
+  GridCell *cell = &job->grid->cells[index];
+  // 场次编号带上等级组合，不同格子的随机序列互不重叠
+  long long first = (long long)(playerLevel * levels + enemyLevel) << 32;
+  double rounds = 0;
+  for (long long n = 0; n < config->battles; ++n) {
+    int health = 0;
+    int turns = 0;
+    long long battle = first | n;
+    int result = simulateBattle(ctx, &simulation, pair / ENERGY_COUNT,
+                                pair % ENERGY_COUNT, battle, &health, &turns);
+    if (result == ACTION_ESCAPED || result == -ACTION_ESCAPED || result == 0) {
+      cell->draws++;
+    } else if (result > 0) {
+      cell->wins++;
+    } else {
+      cell->losses++;
+    }
+    rounds += turns;
+  }
+  cell->rounds = config->battles > 0 ? rounds / config->battles : 0;
+}
+
+int runLevelGrid(const GridConfig *config, LevelGrid *grid) {
+  grid->cells = NULL;
+  if (!checkGridConfig(config)) {
+    return 0;
+  }
+  grid->levels = getGridLevels(config);
+  long long tasks =
+      (long long)ENERGY_COUNT * ENERGY_COUNT * grid->levels * grid->levels;
+  int threads = resolvePoolThreads(config->threads, tasks);
+  grid->cells = calloc(tasks, sizeof(GridCell));
+  Context *contexts = calloc(threads, sizeof(Context));
+  if (grid->cells == NULL || contexts == NULL) {
+    free(grid->cells);
+    free(contexts);
+    grid->cells = NULL;
+    return 0;
+  }
+  for (int t = 0; t < threads; ++t) {
+    initContext(&contexts[t], config->seed, LOG_NONE);
+    contexts[t].presets = config->presets;
+  }
+
+  GridJob job = {.config = config, .grid = grid, .contexts = contexts};
+  int ok = runPool(threads, tasks, playGridCell, &job, &grid->pool);
+  free(contexts);
+  if (!ok) {
+    free(grid->cells);
+    grid->cells = NULL;
+  }
+  return ok;
+}
+
+void freeLevelGrid(LevelGrid *grid) {
+  free(grid->cells);
+  grid->cells = NULL;
+}
+
+int saveLevelGrid(const GridConfig *config, const LevelGrid *grid,
+                  const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return 0;
+  }
+  GridFileHeader header = {.magic = GRID_MAGIC,
+                           .version = GRID_VERSION,
+                           .elementCount = ENERGY_COUNT,
+                           .levelCount = grid->levels,
+                           .levelStep = config->levelStep,
+                           .cellSize = sizeof(GridCell),
+                           .battles = config->battles,
+                           .seed = config->seed};
+  size_t count =
+      (size_t)ENERGY_COUNT * ENERGY_COUNT * grid->levels * grid->levels;
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(grid->cells, sizeof(GridCell), count, file) == count;
+  return fclose(file) == 0 && ok;
+}
\ No newline at end of file
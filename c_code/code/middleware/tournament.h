@@ -0,0 +1,73 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "attribute.h"
+#include "energy.h"
+#include "pool.h"
+
+#define GRID_MAGIC 0x474C4245 // "EBLG"
+#define GRID_VERSION 1
+
+// 场次编号为 (等级组合 << 32) | 场次，battleStream 再把属性组合放在第 48 位，
+// 超出以下范围时不同格子会用到相同的随机序列
+#define GRID_MAX_LEVELS 256 // 等级组合数不超过 2^16
+#define GRID_MAX_BATTLES 0xFFFFFFFFLL
+
+// 属性 × 属性 × 玩家等级 × 敌人等级，等级为 0, step, 2 * step ... maxLevel
+typedef struct {
+  long long battles; // 每格的模拟场数
+  int threads;       // 0 为按 CPU 核心数
+  int maxLevel;
+  int levelStep;
+  uint64_t seed;
+  const PresetTable *presets; // 为空时使用默认预设
+} GridConfig;
+
+// 一格的结果，以玩家为视角
+typedef struct {
+  uint32_t wins;
+  uint32_t losses;
+  uint32_t draws;
+  float rounds; // 平均回合数
+} GridCell;
+
+// 文件头之后是 [玩家属性][敌人属性][玩家等级][敌人等级] 顺序的 GridCell，
+// 每对属性的两个等级维度连续存放，可以直接作为一张热力图读取
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t elementCount;
+  uint32_t levelCount;
+  uint32_t levelStep;
+  uint32_t cellSize;
+  uint64_t battles;
+  uint64_t seed;
+} GridFileHeader;
+
+typedef struct {
+  int levels; // 每个维度的等级数
+  GridCell *cells;
+  PoolStats pool;
+} LevelGrid;
+
+extern int getGridLevels(const GridConfig *config);
+extern int checkGridConfig(const GridConfig *config);
+extern int runLevelGrid(const GridConfig *config, LevelGrid *grid);
+extern void freeLevelGrid(LevelGrid *grid);
+extern GridCell *getGridCell(const LevelGrid *grid, EnergyType playerType,
+                             EnergyType enemyType, int playerLevel,
+                             int enemyLevel);
+extern int saveLevelGrid(const GridConfig *config, const LevelGrid *grid,
+                         const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOURNAMENT_H
\ No newline at end of file
@@ -1,70 +1,956 @@
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "action.h"
 #include "attribute.h"
+#include "balance.h"
+#include "batch.h"
 #include "battle.h"
+#include "combat.h"
 #include "custom.h"
+#include "enemy.h"
+#include "kernel.h"
+#include "elemental.h"
+#include "preset.h"
+#include "profile.h"
 #include "run.h"
+#include "simulation.h"
+#include "solver.h"
+#include "tournament.h"
+#include "trace.h"
 
-void runSimulation() {
-  flag_debug = false;
-  printAllResults();
-}
+// 粗略的停顿代价 (周期)，只用于判断瓶颈的方向
+#define BRANCH_MISS_PENALTY 15
+#define L1D_MISS_PENALTY 12
+#define LLC_MISS_PENALTY 200
+
+void runSimulation() { printAllResults(); }
 
 void runInteractiveMode(EnergyType playerType) {
-  flag_debug = true;
+  Context ctx;
+  initContext(&ctx, time(NULL), LOG_DETAIL);
+
   Energy player = {.name = "player", .type = playerType, .level = 0};
-  getPresetsAttributes(&player);
-  printAttributes(&player);
+  getPresetsAttributes(&ctx, &player);
+  printAttributes(&ctx, &player);
 
   Energy enemy = {.name = "enemy"};
+  EnemyCache enemies;
+  int cached = initEnemyCache(&enemies, ENERGY_COUNT * ENEMY_VARIANTS);
+  uint64_t variantSeed = nextRandom64(&ctx.random);
 
   char command;
-  srand(time(NULL));
 
   while (1) {
-    customPrintf("Enter command: ");
+    customPrintf(&ctx, "Enter command: ");
     scanf_s(" %c", &command);
 
     switch (command) {
     case 's':
-      printAttributes(&player);
+      printAttributes(&ctx, &player);
       break;
     case 'f':
-      enemy.type = rand() % ENERGY_COUNT;
-      getPresetsAttributes(&enemy);
-      enemy.level = 0;
-      upgradeRandom(&enemy, player.level);
-      if (handleBattle(&player, &enemy) > 0) {
-        customPrintf("YOU WIN!\n");
+      enemy.type = randomBelow(&ctx.random, ENERGY_COUNT);
+      if (cached) {
+        // 同一 (属性, 等级) 只有 ENEMY_VARIANTS 种敌人，再次遇到时直接复制
+        spawnEnemy(&enemies, &enemy, enemy.type, player.level,
+                   enemyVariantSeed(variantSeed, randomBelow(&ctx.random,
+                                                             ENEMY_VARIANTS)));
       } else {
-        customPrintf("YOU LOSE!\n");
+        getPresetsAttributes(&ctx, &enemy);
+        enemy.level = 0;
+        upgradeRandom(&ctx, &enemy, player.level);
+      }
+      switch (handleBattle(&ctx, &player, &enemy)) {
+      case ACTION_ESCAPED:
+        customPrintf(&ctx, "ENEMY ESCAPED!\n");
+        break;
+      case -ACTION_ESCAPED:
+        customPrintf(&ctx, "YOU ESCAPED!\n");
+        break;
+      case 1:
+        customPrintf(&ctx, "YOU WIN!\n");
+        break;
+      default:
+        customPrintf(&ctx, "YOU LOSE!\n");
+        break;
       }
       break;
     case 'r':
       restoreAttributes(&player);
-      customPrintf("Your status has been restored.\n");
+      customPrintf(&ctx, "Your status has been restored.\n");
       break;
     case 'u':
-      upgradeChoose(&player);
+      upgradeChoose(&ctx, &player);
       break;
     case 'q':
-      customPrintf("Exiting game.\n");
+      customPrintf(&ctx, "Exiting game.\n");
+      if (cached) {
+        freeEnemyCache(&enemies);
+      }
       return;
     default:
-      customPrintf("Invalid command. Try again.\n");
+      customPrintf(&ctx, "Invalid command. Try again.\n");
       break;
     }
   }
 }
 
 void runBattle(EnergyType playerType, EnergyType enemyType) {
-  flag_debug = true;
+  Context ctx;
+  initContext(&ctx, time(NULL), LOG_DETAIL);
+
   Energy player = {.name = "player", .type = playerType, .level = 0};
   Energy enemy = {.name = "enemy", .type = enemyType, .level = 0};
-  getPresetsAttributes(&player);
-  getPresetsAttributes(&enemy);
-  handleBattleOut(&player, &enemy);
+  getPresetsAttributes(&ctx, &player);
+  getPresetsAttributes(&ctx, &enemy);
+  handleBattleOut(&ctx, &player, &enemy);
+}
+
+void runMonteCarlo(long long battles, int threads, int level,
+                   uint64_t seed, const char *tracePath, int variants,
+                   const char *presetPath, double tolerance) {
+  PresetFile presets = {0};
+  if (presetPath && !openPresetFile(&presets, presetPath)) {
+    printf("cannot load presets from %s\n", presetPath);
+    return;
+  }
+  SimulationConfig config = {.battles = battles,
+                             .threads = threads,
+                             .playerLevel = level,
+                             .enemyLevel = level,
+                             .seed = seed ? seed : (uint64_t)time(NULL),
+                             .tracePath = tracePath,
+                             .enemyVariants = variants,
+                             .presets = presets.table,
+                             .tolerance = tolerance};
+  MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT];
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  simulateMatchups(&config, stats);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  closePresetFile(&presets);
+
+  double seconds =
+      (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  long long total = 0;
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      total += stats[i][j].count;
+    }
+  }
+  printMatchupStats(stats);
+  if (tolerance > 0) {
+    printMatchupCounts(stats);
+  }
+  printf("%lld battles in %.3fs, %.0f battles/s, seed %llu\n", total,
+         seconds, seconds > 0 ? total / seconds : 0,
+         (unsigned long long)config.seed);
+}
+
+static double elapsedSeconds(const struct timespec *start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// 基准为空时使用默认预设，两边共用每场对局的随机序列
+void runComparison(const char *candidatePath, long long battles, int threads,
+                   int level, uint64_t seed, const char *baselinePath,
+                   int antithetic) {
+  PresetFile baseline = {0};
+  PresetFile candidate;
+  if (!openPresetFile(&candidate, candidatePath)) {
+    printf("cannot load presets from %s\n", candidatePath);
+    return;
+  }
+  if (baselinePath && !openPresetFile(&baseline, baselinePath)) {
+    printf("cannot load presets from %s\n", baselinePath);
+    closePresetFile(&candidate);
+    return;
+  }
+  SimulationConfig config = {.battles = battles,
+                             .threads = threads,
+                             .playerLevel = level,
+                             .enemyLevel = level,
+                             .seed = seed ? seed : (uint64_t)time(NULL),
+                             .presets = baseline.table};
+  PairedStats stats[ENERGY_COUNT][ENERGY_COUNT];
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  compareMatchups(&config, candidate.table, antithetic, stats);
+  double seconds = elapsedSeconds(&start);
+  closePresetFile(&candidate);
+  closePresetFile(&baseline);
+
+  // 每个样本两边各一场，对偶模式下各两场
+  long long total =
+      battles * ENERGY_COUNT * ENERGY_COUNT * 2 * (antithetic ? 2 : 1);
+  printPairedStats(stats);
+  printf("%lld battles in %.3fs, %.0f battles/s, seed %llu%s\n", total,
+         seconds, seconds > 0 ? total / seconds : 0,
+         (unsigned long long)config.seed, antithetic ? ", antithetic" : "");
+}
+
+// 对比随机敌人与搜索 AI 敌人的胜率表
+void runEnemySearch(long long battles, int budget, int level, uint64_t seed,
+                    int threads, int nodes) {
+  // 给定种子时按节点数截止，结果可以复现，否则按时间预算
+  SearchConfig search = {.budget = budget,
+                         .maxDepth = 16,
+                         .nodeBudget =
+                             seed ? (nodes > 0 ? nodes : SEARCH_DEFAULT_NODES)
+                                  : 0};
+  SimulationConfig config = {.battles = battles,
+                             .threads = threads,
+                             .playerLevel = level,
+                             .enemyLevel = level,
+                             .seed = seed ? seed : (uint64_t)time(NULL)};
+  MatchupStats random[ENERGY_COUNT][ENERGY_COUNT];
+  MatchupStats smart[ENERGY_COUNT][ENERGY_COUNT];
+
+  simulateMatchups(&config, random);
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  config.enemySearch = &search;
+  simulateMatchups(&config, smart);
+  double seconds = elapsedSeconds(&start);
+
+  printMatchupStats(smart);
+  printf("player win rate shift vs random enemy (%%):\n");
+  printf("%-10s", " ");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+  }
+  printf("\n");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      double before = random[i][j].wins / (double)random[i][j].count;
+      double after = smart[i][j].wins / (double)smart[i][j].count;
+      printf("%+-10.2f", (after - before) * 100);
+    }
+    printf("\n");
+  }
+  long long total = battles * ENERGY_COUNT * ENERGY_COUNT;
+  if (search.nodeBudget > 0) {
+    printf("%lld AI battles in %.3fs, budget %d nodes/move, seed %llu\n",
+           total, seconds, search.nodeBudget, (unsigned long long)config.seed);
+  } else {
+    printf("%lld AI battles in %.3fs, budget %d us/move, seed %llu\n", total,
+           seconds, budget, (unsigned long long)config.seed);
+  }
+}
+
+static void printProfileRow(const Profiler *profiler, const char *name,
+                            const ProfileStat *stat) {
+  printf("%-24s%10llu", name, (unsigned long long)stat->calls);
+  for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c) {
+    if (hasProfileCounter(profiler, c) && stat->calls) {
+      printf("%14.1f", stat->totals[c] / stat->calls);
+    } else {
+      printf("%14s", "n/a");
+    }
+  }
+  printf("\n");
+}
+
+// 根据整场对局的计数器估计瓶颈偏向分支预测还是访存
+static void printProfileSummary(const Profiler *profiler,
+                                const ProfileStat *duel) {
+  if (!hasProfileCounter(profiler, PROFILE_INSTRUCTIONS) ||
+      !hasProfileCounter(profiler, PROFILE_CYCLES)) {
+    printf("hardware counters unavailable, only task clock measured\n");
+    return;
+  }
+  double cycles = duel->totals[PROFILE_CYCLES];
+  double kilo = duel->totals[PROFILE_INSTRUCTIONS] / 1000;
+  double branch = duel->totals[PROFILE_BRANCH_MISSES];
+  double l1 = duel->totals[PROFILE_L1D_MISSES];
+  double llc = duel->totals[PROFILE_LLC_MISSES];
+  printf("IPC %.2f, branch-miss %.2f/ki, L1d-miss %.2f/ki, LLC-miss "
+         "%.2f/ki\n",
+         duel->totals[PROFILE_INSTRUCTIONS] / cycles, branch / kilo,
+         l1 / kilo, llc / kilo);
+
+  double branchStall = branch * BRANCH_MISS_PENALTY / cycles;
+  double memoryStall =
+      (l1 * L1D_MISS_PENALTY + llc * LLC_MISS_PENALTY) / cycles;
+  printf("estimated stalls: branch %.1f%%, memory %.1f%% -> %s\n",
+         branchStall * 100, memoryStall * 100,
+         branchStall > memoryStall ? "branch-bound" : "memory-bound");
+}
+
+// 单线程运行模拟，用硬件计数器计量每场对局和各效果处理阶段
+void runProfile(long long battles, int level, uint64_t seed) {
+  Profiler profiler;
+  if (!initProfiler(&profiler)) {
+    printf("performance counters unavailable\n");
+    return;
+  }
+  SimulationConfig config = {.battles = battles,
+                             .playerLevel = level,
+                             .enemyLevel = level,
+                             .seed = seed ? seed : (uint64_t)time(NULL)};
+  Context ctx;
+  initContext(&ctx, config.seed, LOG_NONE);
+  ctx.profiler = &profiler;
+
+  ProfileStat elements[ENERGY_COUNT] = {0};
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      for (long long n = 0; n < battles; ++n) {
+        int health;
+        int rounds;
+        ProfileSample start;
+        readProfile(&profiler, &start);
+        simulateBattle(&ctx, &config, i, j, n, &health, &rounds);
+        endProfile(&profiler, &elements[i], &start);
+      }
+    }
+  }
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    ProfileStat *duel = &profiler.stages[PROFILE_DUEL];
+    duel->calls += elements[i].calls;
+    for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c) {
+      duel->totals[c] += elements[i].totals[c];
+    }
+  }
+
+  printf("%-24s%10s", "per call", "calls");
+  for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c) {
+    printf("%14s", profileCounterNames[c]);
+  }
+  printf("\n");
+  for (int s = 0; s < PROFILE_STAGE_COUNT; ++s) {
+    printProfileRow(&profiler, profileStageNames[s], &profiler.stages[s]);
+  }
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "duel as %s", energyNames[i]);
+    printProfileRow(&profiler, name, &elements[i]);
+  }
+  printProfileSummary(&profiler, &profiler.stages[PROFILE_DUEL]);
+
+  freeProfiler(&profiler);
+}
+
+// 展开对局树计算各组对局的胜负概率，等级大于 0 时按种子随机升级一次
+// 到达概率低于 cutoff 的状态被截断，截断的概率超过 cutoff 的格子不给出结果，
+// 这时返回 0
+int runSolver(int level, uint64_t seed, int memory, double cutoff) {
+  if (!(cutoff >= 0 && cutoff < 1)) {
+    printf("cutoff must be in [0, 1)\n");
+    return 0;
+  }
+  DuelSolver solver;
+  if (!initSolver(&solver, (size_t)memory << 20)) {
+    printf("cannot allocate %d MB for the solver\n", memory);
+    return 0;
+  }
+  solver.cutoff = cutoff;
+  Context ctx;
+  initContext(&ctx, seed, LOG_NONE);
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  double unresolved = 0;
+  int failed = 0;
+  DuelOdds table[ENERGY_COUNT][ENERGY_COUNT];
+  printf("win / lose / draw %% (reach cutoff %.0e):\n", cutoff);
+  printf("%-10s", " ");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-24s", energyNames[i]);
+  }
+  printf("\n");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      Energy player = {.name = "player", .type = i};
+      Energy enemy = {.name = "enemy", .type = j};
+      getPresetsAttributes(&ctx, &player);
+      getPresetsAttributes(&ctx, &enemy);
+      upgradeRandom(&ctx, &player, level);
+      upgradeRandom(&ctx, &enemy, level);
+      DuelOdds odds = solveDuel(&solver, &player, &enemy);
+      // 截断过多时各项只是下界，不当作结果输出
+      if (odds.unresolved > cutoff) {
+        printf("%-25s", "  unresolved");
+        failed++;
+      } else {
+        printf("%6.2f/%6.2f/%6.2f     ", odds.win * 100, odds.lose * 100,
+               odds.draw * 100);
+      }
+      unresolved = odds.unresolved > unresolved ? odds.unresolved : unresolved;
+      table[i][j] = odds;
+    }
+    printf("\n");
+  }
+  // 每格的胜、负、平与真实值的差都不超过该格的 unresolved
+  printf("unresolved:\n");
+  printf("%-10s", " ");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-24s", energyNames[i]);
+  }
+  printf("\n");
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    printf("%-12s", energyNames[i]);
+    for (int j = 0; j < ENERGY_COUNT; ++j) {
+      printf("%-25.2e", table[i][j].unresolved);
+    }
+    printf("\n");
+  }
+  printf("max unresolved %.2e (cutoff %.0e)\n", unresolved, cutoff);
+  printf("%llu states, %llu hits, %llu evictions in %.3fs\n",
+         (unsigned long long)solver.states, (unsigned long long)solver.hits,
+         (unsigned long long)solver.evictions, elapsedSeconds(&start));
+  if (failed) {
+    printf("%d of %d cells left more than %.0e unresolved and have no "
+           "result, estimate them with sim\n",
+           failed, ENERGY_COUNT * ENERGY_COUNT, cutoff);
+  }
+
+  freeSolver(&solver);
+  return failed == 0;
+}
+
+// 对比特化内核、结构体数组批量路径与逐场 handleBattleOut 的结果和速度
+void runBatchBenchmark(int duels, int level) {
+  Context ctx;
+  initContext(&ctx, time(NULL), LOG_NONE);
+
+  DuelBatch batch;
+  Energy *players = malloc(sizeof(Energy) * duels * 6);
+  int *results = malloc(sizeof(int) * duels * 3);
+  if (players == NULL || results == NULL || !initBatch(&batch, 1024)) {
+    free(players);
+    free(results);
+    return;
+  }
+  Energy *enemies = players + duels;
+  Energy *kernelPlayers = enemies + duels;
+  Energy *kernelEnemies = kernelPlayers + duels;
+  Energy *batchPlayers = kernelEnemies + duels;
+  Energy *batchEnemies = batchPlayers + duels;
+
+  for (int i = 0; i < duels; ++i) {
+    players[i] = (Energy){.name = "player",
+                          .type = randomBelow(&ctx.random, ENERGY_COUNT)};
+    enemies[i] = (Energy){.name = "enemy",
+                          .type = randomBelow(&ctx.random, ENERGY_COUNT)};
+    getPresetsAttributes(&ctx, &players[i]);
+    getPresetsAttributes(&ctx, &enemies[i]);
+    upgradeRandom(&ctx, &players[i], level);
+    upgradeRandom(&ctx, &enemies[i], level);
+  }
+  memcpy(kernelPlayers, players, sizeof(Energy) * duels * 2);
+  memcpy(batchPlayers, players, sizeof(Energy) * duels * 2);
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < duels; ++i) {
+    results[i] = handleBattleOut(&ctx, &players[i], &enemies[i]);
+  }
+  double scalarSeconds = elapsedSeconds(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < duels; ++i) {
+    results[duels + i] =
+        handleBattleKernel(&ctx, &kernelPlayers[i], &kernelEnemies[i]);
+  }
+  double kernelSeconds = elapsedSeconds(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int batched = handleBattleBatch(&ctx, &batch, batchPlayers, batchEnemies,
+                                  duels, results + duels * 2);
+  double batchSeconds = elapsedSeconds(&start);
+
+  int kernelMismatches = 0;
+  int batchMismatches = 0;
+  for (int i = 0; i < duels; ++i) {
+    kernelMismatches +=
+        results[i] != results[duels + i] ||
+        memcmp(&players[i], &kernelPlayers[i], sizeof(Energy)) ||
+        memcmp(&enemies[i], &kernelEnemies[i], sizeof(Energy));
+    batchMismatches +=
+        results[i] != results[duels * 2 + i] ||
+        memcmp(&players[i], &batchPlayers[i], sizeof(Energy)) ||
+        memcmp(&enemies[i], &batchEnemies[i], sizeof(Energy));
+  }
+
+  printf("scalar: %.0f duels/s\n", duels / scalarSeconds);
+  printf("kernel: %.0f duels/s (%.2fx)\n", duels / kernelSeconds,
+         scalarSeconds / kernelSeconds);
+  printf("batch:  %.0f duels/s (%.2fx), %d of %d duels in lanes\n",
+         duels / batchSeconds, scalarSeconds / batchSeconds, batched, duels);
+  printf("mismatches: kernel %d, batch %d\n", kernelMismatches,
+         batchMismatches);
+
+  freeBatch(&batch);
+  free(players);
+  free(results);
+}
+
+// 对比各曲线方案查表与 pow 的求值速度、误差和取整结果
+void runCurveBenchmark(int samples) {
+  Random random;
+  seedRandom(&random, 1);
+  double *ratios = malloc(sizeof(double) * samples * 2);
+  if (ratios == NULL) {
+    return;
+  }
+  double *scales = ratios + samples;
+  for (int i = 0; i < samples; ++i) {
+    ratios[i] = randomUnit(&random) * 1.2;
+    scales[i] = randomUnit(&random) * 64;
+  }
+
+  printf("%-10s%12s%12s%10s%14s%12s\n", "scheme", "exact ns", "table ns",
+         "speedup", "max error", "mismatches");
+  for (int s = 0; s < CURVE_COUNT; ++s) {
+    CurveConfig exact = {s, CURVE_EXACT};
+    CurveConfig table = {s, CURVE_TABLE};
+    long long exactSum = 0;
+    long long tableSum = 0;
+    struct timespec start;
+
+    getCurveTable(s);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < samples; ++i) {
+      exactSum += curveAdjustValue(&exact, scales[i], ratios[i]);
+    }
+    double exactSeconds = elapsedSeconds(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < samples; ++i) {
+      tableSum += curveAdjustValue(&table, scales[i], ratios[i]);
+    }
+    double tableSeconds = elapsedSeconds(&start);
+
+    double maxError = 0;
+    int mismatches = 0;
+    for (int i = 0; i < samples; ++i) {
+      double error = fabs(curveValue(&table, ratios[i]) -
+                          curveValue(&exact, ratios[i]));
+      maxError = error > maxError ? error : maxError;
+      mismatches += curveAdjustValue(&table, scales[i], ratios[i]) !=
+                    curveAdjustValue(&exact, scales[i], ratios[i]);
+    }
+
+    printf("%-10s%12.1f%12.1f%9.2fx%14.3e%12d\n", curveNames[s],
+           exactSeconds * 1e9 / samples, tableSeconds * 1e9 / samples,
+           exactSeconds / tableSeconds, maxError,
+           mismatches + (exactSum != tableSum));
+  }
+
+  free(ratios);
+}
+
+// 解码模拟输出的二进制轨迹文件
+void runDecode(const char *path, int csv) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    printf("cannot open %s\n", path);
+    return;
+  }
+  if (decodeTrace(file, stdout, csv ? TRACE_CSV : TRACE_TEXT) != 0) {
+    printf("invalid trace file %s\n", path);
+  }
+  fclose(file);
+}
+
+// 按种子和场次重放模拟中的某一场对局，并输出完整日志
+void runReplay(uint64_t seed, int level, EnergyType playerType,
+               EnergyType enemyType, long long index, int nodes) {
+  SimulationConfig config = {
+      .seed = seed, .playerLevel = level, .enemyLevel = level};
+  Context ctx;
+  initContext(&ctx, seed, LOG_DETAIL);
+
+  // 与 ai 模拟相同的节点预算下，敌人 AI 的每一步都可以复现
+  SearchConfig searchConfig = {.maxDepth = 16, .nodeBudget = nodes};
+  DuelSearch search;
+  if (nodes > 0 && initSearch(&search, &searchConfig)) {
+    ctx.search = &search;
+  }
+
+  int health = 0;
+  int rounds = 0;
+  int result = simulateBattle(&ctx, &config, playerType, enemyType, index,
+                              &health, &rounds);
+  printf("result: %d, health: %d, rounds: %d\n", result, health, rounds);
+  if (ctx.search) {
+    freeSearch(ctx.search);
+  }
+}
+
+// 启用灵根子集的数量，不含空集
+#define TEAM_SUBSET_COUNT ((1 << ENERGY_COUNT) - 1)
+
+typedef struct {
+  unsigned int aptitudes;
+  long long wins;
+  long long losses;
+  long long draws;
+  double worstRate; // 对最难对手的胜率
+  unsigned int worstEnemy;
+} TeamRecord;
+
+static void formatAptitudes(unsigned int aptitudes, char *text, size_t size) {
+  text[0] = '\0';
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    if ((aptitudes >> i) & 1) {
+      strncat(text, energyNames[i], size - strlen(text) - 1);
+    }
+  }
+}
+
+// 与 Flutter 端 RandomEnemy 相同，每个启用的灵根随机分配 level 个属性点
+static void randomTeamConfigs(Context *ctx, EnergyConfig configs[ENERGY_COUNT],
+                              unsigned int aptitudes, int level) {
+  initEnergyConfigs(configs, aptitudes, 2);
+  for (int i = 0; i < ENERGY_COUNT; ++i) {
+    if (configs[i].aptitude) {
+      int points[ATTRIBUTE_COUNT];
+      randomMultinomial(&ctx->random, level, points, ATTRIBUTE_COUNT);
+      configs[i].healthPoints = points[HP];
+      configs[i].attackPoints = points[ATK];
+      configs[i].defencePoints = points[DEF];
+    }
+  }
+}
+
+static int compareTeamRecord(const void *a, const void *b) {
+  const TeamRecord *left = a;
+  const TeamRecord *right = b;
+  return (right->wins > left->wins) - (right->wins < left->wins);
+}
+
+// 所有启用灵根子集之间的队伍循环赛，按总胜率排序输出
+void runTeamTournament(long long battles, int level, uint64_t seed) {
+  seed = seed ? seed : (uint64_t)time(NULL);
+  Context ctx;
+  initContext(&ctx, seed, LOG_NONE);
+  TeamRecord records[TEAM_SUBSET_COUNT];
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int p = 0; p < TEAM_SUBSET_COUNT; ++p) {
+    TeamRecord *record = &records[p];
+    *record = (TeamRecord){.aptitudes = p + 1, .worstRate = 2};
+    for (int e = 0; e < TEAM_SUBSET_COUNT; ++e) {
+      long long wins = 0;
+      for (long long n = 0; n < battles; ++n) {
+        seedRandomStream(&ctx.random, seed,
+                         ((uint64_t)(p * TEAM_SUBSET_COUNT + e) << 40) | n);
+        EnergyConfig configs[ENERGY_COUNT];
+        Elemental player;
+        Elemental enemy;
+        randomTeamConfigs(&ctx, configs, p + 1, level);
+        initElemental(&ctx, &player, "player", configs);
+        randomTeamConfigs(&ctx, configs, e + 1, level);
+        initElemental(&ctx, &enemy, "enemy", configs);
+
+        int rounds = 0;
+        int result = handleBattleTeam(&ctx, &player, &enemy, &rounds);
+        if (result == 1) {
+          wins++;
+        } else if (result == -1) {
+          record->losses++;
+        } else {
+          record->draws++; // 逃跑与回合耗尽
+        }
+      }
+      record->wins += wins;
+      double rate = battles > 0 ? wins / (double)battles : 0;
+      if (rate < record->worstRate) {
+        record->worstRate = rate;
+        record->worstEnemy = e + 1;
+      }
+    }
+  }
+  double seconds = elapsedSeconds(&start);
+
+  qsort(records, TEAM_SUBSET_COUNT, sizeof(TeamRecord), compareTeamRecord);
+  printf("%-22s%8s%8s%8s  %-22s%8s\n", "team", "win %", "lose %", "draw %",
+         "hardest enemy", "win %");
+  for (int i = 0; i < TEAM_SUBSET_COUNT; ++i) {
+    const TeamRecord *record = &records[i];
+    double total = (double)battles * TEAM_SUBSET_COUNT;
+    char team[64];
+    char enemy[64];
+    formatAptitudes(record->aptitudes, team, sizeof(team));
+    formatAptitudes(record->worstEnemy, enemy, sizeof(enemy));
+    // 每个灵根图标占 4 字节、2 列宽，按显示宽度补齐
+    printf("%s%*s%8.2f%8.2f%8.2f  %s%*s%8.2f\n", team,
+           (int)(22 - strlen(team) / 2), "", record->wins * 100 / total,
+           record->losses * 100 / total, record->draws * 100 / total, enemy,
+           (int)(22 - strlen(enemy) / 2), "", record->worstRate * 100);
+  }
+  long long total = battles * TEAM_SUBSET_COUNT * TEAM_SUBSET_COUNT;
+  printf("%lld team battles in %.3fs, %.0f battles/s, seed %llu\n", total,
+         seconds, seconds > 0 ? total / seconds : 0,
+         (unsigned long long)seed);
+}
+
+// 坐标搜索调整预设，使各组合的得分率逼近目标，可从检查点继续
+void runBalance(long long battles, long long evaluations, uint64_t seed,
+                const char *checkpointPath, const char *targetsPath) {
+  BalanceConfig config;
+  initBalanceConfig(&config);
+  config.battles = battles;
+  config.evaluations = evaluations;
+  config.checkpointPath = checkpointPath;
+  if (targetsPath && !loadBalanceTargets(&config, targetsPath)) {
+    printf("cannot read 25 targets from %s\n", targetsPath);
+    return;
+  }
+
+  BalanceState state;
+  initBalanceState(&state);
+  if (checkpointPath && loadBalanceState(&state, checkpointPath)) {
+    printf("resumed from %s\n", checkpointPath);
+    // 沿用检查点的种子，否则需要重新评估当前参数
+    seed = seed ? seed : state.seed;
+  }
+  config.seed = seed ? seed : (uint64_t)time(NULL);
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int converged = optimizeBalance(&config, &state);
+  double seconds = elapsedSeconds(&start);
+  if (checkpointPath) {
+    // 结果另存为预设文件，sim 可以直接映射使用
+    char presetPath[1024];
+    snprintf(presetPath, sizeof(presetPath), "%s.presets", checkpointPath);
+    savePresetFile(&state.presets, presetPath);
+  }
+
+  MatchupStats stats[ENERGY_COUNT][ENERGY_COUNT];
+  evaluateBalance(&config, &state.presets, state.scheme, stats);
+  printMatchupStats(stats);
+  printBalanceState(&state);
+  printf("%s in %.3fs, seed %llu\n", converged ? "converged" : "stopped",
+         seconds, (unsigned long long)config.seed);
+}
+
+// 不带 output 时映射并打印预设文件，带 output 时把默认预设写入该文件
+void runPresets(const char *path, int output) {
+  if (output) {
+    if (!savePresetFile(&defaultPresets, path)) {
+      printf("cannot write presets to %s\n", path);
+      return;
+    }
+    printf("default presets written to %s\n", path);
+    return;
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  PresetFile file;
+  int ok = openPresetFile(&file, path);
+  double seconds = elapsedSeconds(&start);
+  if (!ok) {
+    printf("cannot load presets from %s\n", path);
+    return;
+  }
+  printPresetTable(file.table);
+  printf("%zu bytes mapped in %.1fus\n", file.size, seconds * 1e6);
+  closePresetFile(&file);
+}
+
+// 完整结果写入热力图文件，终端只打印同等级下最失衡的组合
+void runLevelTournament(long long battles, int maxLevel, int levelStep,
+                        uint64_t seed, const char *outputPath, int threads,
+                        const char *presetPath) {
+  PresetFile presets = {0};
+  if (presetPath && !openPresetFile(&presets, presetPath)) {
+    printf("cannot load presets from %s\n", presetPath);
+    return;
+  }
+  GridConfig config = {.battles = battles,
+                       .threads = threads,
+                       .maxLevel = maxLevel,
+                       .levelStep = levelStep,
+                       .seed = seed ? seed : (uint64_t)time(NULL),
+                       .presets = presets.table};
+  LevelGrid grid;
+  if (!checkGridConfig(&config)) {
+    printf("at most %d levels and %lld battles per cell\n", GRID_MAX_LEVELS,
+           GRID_MAX_BATTLES);
+    closePresetFile(&presets);
+    return;
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int ok = runLevelGrid(&config, &grid);
+  double seconds = elapsedSeconds(&start);
+  closePresetFile(&presets);
+  if (!ok) {
+    printf("out of memory\n");
+    return;
+  }
+
+  printf("%8s%10s%10s  %-12s%10s\n", "level", "min %", "max %",
+         "worst pair", "rounds");
+  for (int l = 0; l < grid.levels; ++l) {
+    double minimum = 1;
+    double maximum = 0;
+    double rounds = 0;
+    int worst = 0;
+    for (int pair = 0; pair < ENERGY_COUNT * ENERGY_COUNT; ++pair) {
+      const GridCell *cell = getGridCell(&grid, pair / ENERGY_COUNT,
+                                         pair % ENERGY_COUNT, l, l);
+      double rate = battles > 0 ? cell->wins / (double)battles : 0;
+      minimum = rate < minimum ? rate : minimum;
+      if (rate > maximum) {
+        maximum = rate;
+        worst = pair;
+      }
+      rounds += cell->rounds;
+    }
+    // 每个属性图标占 4 字节、2 列宽，按显示宽度补齐
+    printf("%8d%10.2f%10.2f  %s vs %s%4s%10.2f\n", l * levelStep,
+           minimum * 100, maximum * 100, energyNames[worst / ENERGY_COUNT],
+           energyNames[worst % ENERGY_COUNT], "",
+           rounds / (ENERGY_COUNT * ENERGY_COUNT));
+  }
+
+  long long cells = (long long)ENERGY_COUNT * ENERGY_COUNT * grid.levels *
+                    grid.levels;
+  long long total = cells * battles;
+  printf("%lld cells, %lld battles in %.3fs, %.0f battles/s, seed %llu\n",
+         cells, total, seconds, seconds > 0 ? total / seconds : 0,
+         (unsigned long long)config.seed);
+  printf("%d threads, %llu steals, %llu stolen cells\n", grid.pool.threads,
+         (unsigned long long)grid.pool.steals,
+         (unsigned long long)grid.pool.stolenTasks);
+  if (outputPath && !saveLevelGrid(&config, &grid, outputPath)) {
+    printf("cannot write %s\n", outputPath);
+  } else if (outputPath) {
+    printf("heatmap written to %s\n", outputPath);
+  }
+  freeLevelGrid(&grid);
+}
+
+// 足够容纳整条反击链，不会覆盖最早的事件
+#define CHECK_TRACE_CAPACITY 64
+
+// 双方都带两次坚韧 (0.75) 与一次两连的立即反击时，土对土一次攻击的全部事件，
+// 由加入反击链层数上限之前的实现记录，反击顺序改变时这里会不一致
+static const TraceEvent counterChainEvents[] = {
+    {TRACE_DAMAGE, 1, 0, 0, 16, 368},
+    {TRACE_COUNTER, 1, 0, 0, 1, 368},
+    {TRACE_DAMAGE, 0, 0, 0, 9, 375},
+    {TRACE_COUNTER, 0, 0, 0, 1, 375},
+    {TRACE_DAMAGE, 1, 0, 0, 5, 363},
+    {TRACE_COUNTER, 1, 0, 0, 1, 363},
+    {TRACE_DAMAGE, 0, 0, 0, 12, 363},
+    {TRACE_COUNTER, 0, 0, 0, 1, 363},
+    {TRACE_DAMAGE, 1, 0, 0, 12, 351},
+    {TRACE_COUNTER, 1, 1, 0, 2, 351},
+    {TRACE_DAMAGE, 0, 0, 0, 33, 330},
+    {TRACE_COUNTER, 0, 1, 0, 2, 330},
+    {TRACE_DAMAGE, 1, 0, 0, 44, 307},
+    {TRACE_DAMAGE, 1, 0, 0, 16, 291},
+    {TRACE_DAMAGE, 0, 0, 0, 46, 284},
+};
+
+static int checkCounterChain(void) {
+  Context ctx;
+  initContext(&ctx, 1, LOG_NONE);
+  TraceBuffer trace;
+  if (!initTrace(&trace, CHECK_TRACE_CAPACITY)) {
+    return 0;
+  }
+  ctx.trace = &trace;
+
+  Energy player = {.name = "player", .type = EARTH};
+  Energy enemy = {.name = "enemy", .type = EARTH};
+  beginTrace(&trace, &player, &enemy);
+  Energy *energies[2] = {&player, &enemy};
+  for (int i = 0; i < 2; ++i) {
+    getPresetsAttributes(&ctx, energies[i]);
+    energies[i]->effects[rugged].value = 0.75;
+    setEffectTimes(energies[i], rugged, 2);
+    energies[i]->effects[revengeAtonce].value = 2;
+    setEffectTimes(energies[i], revengeAtonce, 1);
+  }
+  handleCombat(&ctx, &player, &enemy);
+
+  int count = sizeof(counterChainEvents) / sizeof(TraceEvent);
+  int ok = trace.head == (uint64_t)count;
+  for (int k = 0; ok && k < count; ++k) {
+    const TraceEvent *expected = &counterChainEvents[k];
+    const TraceEvent *actual = &trace.events[k];
+    ok = actual->type == expected->type && actual->actor == expected->actor &&
+         actual->detail == expected->detail &&
+         actual->value == expected->value &&
+         actual->health == expected->health;
+  }
+  printf("counter chain: %s (%llu of %d events)\n", ok ? "ok" : "MISMATCH",
+         (unsigned long long)trace.head, count);
+  freeTrace(&trace);
+  return ok;
+}
+
+#define ENERGY_BIT(type) (1u << (type))
+
+// Flutter 端 switchPrevious 的结果，按 findNextIndex 在 EnergyType.values
+// (金木水火土) 上倒退一步推出，[当前灵根] 为切换后的灵根
+static const struct {
+  unsigned int aptitudes;
+  EnergyType previous[ENERGY_COUNT];
+} switchCases[] = {
+    {(1u << ENERGY_COUNT) - 1,
+     {[METAL] = EARTH, [WOOD] = METAL, [WATER] = WOOD, [FIRE] = WATER,
+      [EARTH] = FIRE}},
+    {ENERGY_BIT(WATER) | ENERGY_BIT(EARTH),
+     {[METAL] = EARTH, [WOOD] = EARTH, [WATER] = EARTH, [FIRE] = WATER,
+      [EARTH] = WATER}},
+    {ENERGY_BIT(METAL) | ENERGY_BIT(FIRE),
+     {[METAL] = FIRE, [WOOD] = METAL, [WATER] = METAL, [FIRE] = METAL,
+      [EARTH] = FIRE}},
+    {ENERGY_BIT(WOOD),
+     {[METAL] = WOOD, [WOOD] = WOOD, [WATER] = WOOD, [FIRE] = WOOD,
+      [EARTH] = WOOD}},
+};
+
+static int checkSwitchPrevious(void) {
+  int count = sizeof(switchCases) / sizeof(switchCases[0]);
+  int mismatches = 0;
+  for (int c = 0; c < count; ++c) {
+    Elemental elemental = {.aptitudes = switchCases[c].aptitudes};
+    for (int i = 0; i < ENERGY_COUNT; ++i) {
+      elemental.energies[i].health = 1;
+    }
+    for (int slot = 0; slot < ENERGY_COUNT; ++slot) {
+      elemental.current = slot;
+      switchPrevious(&elemental);
+      if (elemental.current != switchCases[c].previous[slot]) {
+        printf("switch previous: from %s got %s, flutter %s\n",
+               energyNames[slot], energyNames[elemental.current],
+               energyNames[switchCases[c].previous[slot]]);
+        mismatches++;
+      }
+    }
+  }
+  printf("switch previous: %s (%d cases)\n", mismatches ? "MISMATCH" : "ok",
+         count * ENERGY_COUNT);
+  return mismatches == 0;
+}
+
+// 逐项对比与原实现约定的行为，全部一致时返回 1
+int runCheck(void) {
+  int ok = checkCounterChain();
+  ok = checkSwitchPrevious() && ok;
+  printf("%s\n", ok ? "all checks passed" : "check failed");
+  return ok;
 }
\ No newline at end of file
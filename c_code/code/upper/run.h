@@ -1,18 +1,43 @@
-#ifndef BATTLE_H
-#define BATTLE_H
+#ifndef RUN_H
+#define RUN_H
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#include <stdint.h>
+
 #include "energy.h"
 
 extern void runSimulation();
 extern void runInteractiveMode(EnergyType playerType);
 extern void runBattle(EnergyType playerType, EnergyType enemyType);
+extern void runMonteCarlo(long long battles, int threads, int level,
+                          uint64_t seed, const char *tracePath, int variants,
+                          const char *presetPath, double tolerance);
+extern void runComparison(const char *candidatePath, long long battles,
+                          int threads, int level, uint64_t seed,
+                          const char *baselinePath, int antithetic);
+extern void runEnemySearch(long long battles, int budget, int level,
+                           uint64_t seed, int threads, int nodes);
+extern void runTeamTournament(long long battles, int level, uint64_t seed);
+extern void runBalance(long long battles, long long evaluations, uint64_t seed,
+                       const char *checkpointPath, const char *targetsPath);
+extern void runPresets(const char *path, int output);
+extern void runLevelTournament(long long battles, int maxLevel, int levelStep,
+                               uint64_t seed, const char *outputPath,
+                               int threads, const char *presetPath);
+extern int runSolver(int level, uint64_t seed, int memory, double cutoff);
+extern void runProfile(long long battles, int level, uint64_t seed);
+extern void runBatchBenchmark(int duels, int level);
+extern void runCurveBenchmark(int samples);
+extern void runDecode(const char *path, int csv);
+extern void runReplay(uint64_t seed, int level, EnergyType playerType,
+                      EnergyType enemyType, long long index, int nodes);
+extern int runCheck(void);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // BATTLE_H
\ No newline at end of file
+#endif // RUN_H
\ No newline at end of file